@@ -35,20 +35,74 @@ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
 //---necessary standard libraries---------------------------------------------------------------------------------------
 #include <thread>      // for std::thread, std::this_thread::yield, std::this_thread::sleep_for
 #include <mutex>       // for std::mutex, std::lock_guard
+#include <condition_variable> // for std::condition_variable
 #include <atomic>      // for std::atomic
 #include <future>      // for std::future, std::promise
 #include <functional>  // for std::function
 #include <queue>       // for std::queue
+#include <unordered_map> // for std::unordered_map
+#include <vector>      // for std::vector
+#include <algorithm>   // for std::find, std::sort
+#include <string>      // for std::string, std::to_string
+#include <fstream>     // for std::ifstream
 #include <chrono>      // for std::chrono::nanoseconds, std::chrono::high_resolution_clock, std::chrono::steady_clock
 #include <ostream>     // for std::ostream
 #include <iostream>    // for std::clog
 #include <memory>      // for std::unique_ptr
 #include <utility>     // for std::declval, std::move
 #include <type_traits> // for std::is_function, std::is_same, std::enable_if, std::conditional, std:: true_type, std::false_type
+#include <cstdint>     // for uintptr_t
+#include <new>         // for placement new
+#include <tuple>       // for std::tuple
 //---conditionally necessary standard libraries-------------------------------------------------------------------------
 #if defined(STZ_DEBUGGING)
 # include <cstdio>     // for std::sprintf
 #endif
+#if defined(__unix__) or defined(__APPLE__)
+# define  _stz_impl_PTHREAD
+# include <pthread.h>  // for pthread_create, pthread_join, pthread_attr_setstacksize
+# include <climits>    // for PTHREAD_STACK_MIN
+#endif
+#if defined(__linux__)
+# define  _stz_impl_AFFINITY
+# include <sched.h>    // for sched_getaffinity, cpu_set_t, CPU_SET, CPU_ISSET
+# define  _stz_impl_REACTOR
+# include <sys/epoll.h>   // for epoll_create1, epoll_ctl, epoll_wait
+# include <sys/eventfd.h> // for eventfd
+# include <sys/socket.h>  // for recv, send, accept
+# include <sys/mman.h>    // for mmap, munmap
+# include <sys/syscall.h> // for syscall, __NR_io_uring_setup, __NR_io_uring_enter
+# include <unistd.h>      // for read, write, pread, pwrite, close
+# include <fcntl.h>       // for fcntl, O_NONBLOCK
+# include <cerrno>        // for errno
+# include <deque>         // for std::deque
+# include <unordered_set> // for std::unordered_set
+# if defined(__has_include)
+#   if __has_include(<linux/io_uring.h>)
+#     include <linux/io_uring.h> // for io_uring_params, io_uring_sqe, io_uring_cqe
+#     if defined(__NR_io_uring_setup) and defined(IORING_FEAT_RW_CUR_POS)
+#       define _stz_impl_IO_URING
+#     endif
+#   endif
+# endif
+#endif
+#if defined(__linux__) and defined(__GLIBC__)
+# define  _stz_impl_FIBERS
+# include <ucontext.h> // for ucontext_t, getcontext, makecontext, swapcontext
+#endif
+#if defined(__linux__) and defined(__GLIBC__)
+# define  _stz_impl_SHARED
+# include <fcntl.h>       // for O_CREAT, O_EXCL, O_RDWR
+# include <sys/stat.h>    // for fstat
+# include <linux/futex.h> // for FUTEX_WAIT, FUTEX_WAKE
+# include <signal.h>      // for kill
+#endif
+#if defined(__cpp_impl_coroutine) and (__cplusplus >= 202002L)
+# define  _stz_impl_COROUTINES
+# include <coroutine>  // for std::coroutine_handle, std::suspend_always, std::noop_coroutine
+# include <optional>   // for std::optional
+# include <exception>  // for std::exception_ptr, std::current_exception, std::rethrow_exception
+#endif
 //*///------------------------------------------------------------------------------------------------------------------
 namespace stz
 {
@@ -57,19 +111,174 @@ inline namespace nimata
 {
   const unsigned max_threads = std::thread::hardware_concurrency();
 
+  // stack size of worker threads, 0 is the platform default
+# if defined(NIMATA_STACK_SIZE)
+  const size_t default_stack_size = NIMATA_STACK_SIZE;
+# else
+  const size_t default_stack_size = 0;
+# endif
+
+# if defined(_stz_impl_FIBERS)
+  // stack size of fibers
+#   if defined(NIMATA_FIBER_STACK_SIZE)
+  const size_t fiber_stack_size = NIMATA_FIBER_STACK_SIZE;
+#   else
+  const size_t fiber_stack_size = 256 * 1024;
+#   endif
+# endif
+
   class Pool;
 
+  // bounded set of workers that pools can share
+  class Arena;
+
+  // process-wide arena
+  inline auto arena() noexcept -> Arena&;
+
+  namespace this_worker
+  {
+    // index of the calling thread amongst the workers of its arena, -1 if it is not a worker
+    inline auto index() noexcept -> signed;
+  }
+
+  // scope in which the calling worker blocks, a spare worker takes its place meanwhile
+  class blocking_region;
+
 # define cyclic_async(PERIOD)
 
   enum class Tracking : uint_fast8_t
   {
-    bound, // return std::future
-    stray, // return void
-    infer  // return_type == void ? void : std::future
+    bound,   // return std::future
+    stray,   // return void
+    chained, // return stz::Future
+    infer    // return_type == void ? void : std::future
+  };
+
+  constexpr Tracking bound   = Tracking::bound;
+  constexpr Tracking stray   = Tracking::stray;
+  constexpr Tracking chained = Tracking::chained;
+
+  // handle to a delayed task, which can be cancelled until it is due
+  class Timer;
+
+  // handle to a queue of tasks that run in order and one at a time
+  class Strand;
+
+  // buffer of tasks pushed by one thread, published to a pool all at once
+  class Producer;
+
+  // lightweight future whose result can be chained onto a pool with 'then'
+  template<typename Type>
+  class Future;
+
+  // future ready once all 'futures' are, holding them
+  template<typename... Types>
+  auto when_all(Future<Types>&&... futures) noexcept -> Future<std::tuple<Future<Types>...>>;
+
+  // future ready once all 'futures' are, holding them
+  template<typename Type>
+  auto when_all(std::vector<Future<Type>> futures) noexcept -> Future<std::vector<Future<Type>>>;
+
+  // result of when_any, 'futures[index]' is the first future that was ready
+  template<typename Sequence>
+  struct WhenAny;
+
+  // future ready as soon as one of 'futures' is, holding them
+  template<typename... Types>
+  auto when_any(Future<Types>&&... futures) noexcept -> Future<WhenAny<std::tuple<Future<Types>...>>>;
+
+  // future ready as soon as one of 'futures' is, holding them
+  template<typename Type>
+  auto when_any(std::vector<Future<Type>> futures) noexcept -> Future<WhenAny<std::vector<Future<Type>>>>;
+
+  // reusable graph of tasks whose edges are dependencies
+  class TaskGraph;
+
+  // fork-join scope whose children can spawn scopes of their own
+  class TaskGroup;
+
+  // run every callable concurrently on 'pool' and the calling thread, returns once they are all done
+  template<typename... Callables>
+  void parallel_invoke(Pool& pool, Callables&&... callables) noexcept;
+
+  // chain of stages that items stream through, with a bounded amount of items in flight
+  class Pipeline;
+
+  // bounded multi-producer multi-consumer channel
+  template<typename Type>
+  class Channel;
+
+  // single-use barrier that opens once counted down to zero
+  class Latch;
+
+# if defined(_stz_impl_REACTOR)
+  enum class Backend : uint_fast8_t
+  {
+    epoll,   // readiness notifications, operations are performed by the reactor thread
+    io_uring // completion notifications, operations are performed by the kernel
+  };
+
+  constexpr Backend epoll    = Backend::epoll;
+  constexpr Backend io_uring = Backend::io_uring;
+
+  // asynchronous I/O whose completions are scheduled onto a pool
+  class Reactor;
+# endif
+
+# if defined(_stz_impl_SHARED)
+  // ring of serialized tasks in shared memory, consumed by the pools of several processes
+  class SharedQueue;
+# endif
+
+  enum class Stage : uint_fast8_t
+  {
+    parallel,         // items are processed concurrently, in any order
+    parallel_ordered, // items are processed concurrently and handed to the next stage in input order
+    serial,           // items are processed one at a time, in input order
+    serial_unordered  // items are processed one at a time, in any order
+  };
+
+  constexpr Stage parallel         = Stage::parallel;
+  constexpr Stage parallel_ordered = Stage::parallel_ordered;
+  constexpr Stage serial           = Stage::serial;
+  constexpr Stage serial_unordered = Stage::serial_unordered;
+
+# if defined(_stz_impl_COROUTINES)
+  // lazily started coroutine whose result is awaitable
+  template<typename Type = void>
+  class Task;
+# endif
+
+  enum class Overflow : uint_fast8_t
+  {
+    block,       // wait for room, workers of the pool run the task themselves instead
+    drop_oldest, // discard the oldest queued task to make room
+    caller_runs  // run the task on the pushing thread
+  };
+
+  constexpr Overflow block       = Overflow::block;
+  constexpr Overflow drop_oldest = Overflow::drop_oldest;
+  constexpr Overflow caller_runs = Overflow::caller_runs;
+
+  enum class Startup : uint_fast8_t
+  {
+    eager,  // spawn threads upon construction
+    lazy,   // spawn threads upon first submission
+    gradual // spawn threads upon first submission, workers one at a time as demand grows
   };
 
-  constexpr Tracking bound = Tracking::bound;
-  constexpr Tracking stray = Tracking::stray;
+  constexpr Startup eager   = Startup::eager;
+  constexpr Startup lazy    = Startup::lazy;
+  constexpr Startup gradual = Startup::gradual;
+
+  enum class Placement : uint_fast8_t
+  {
+    floating,      // as many workers as asked, placed by the operating system
+    physical_cores // one worker bound to each physical core, in cache-sharing order
+  };
+
+  constexpr Placement floating       = Placement::floating;
+  constexpr Placement physical_cores = Placement::physical_cores;
 
   struct io
   {
@@ -224,700 +433,6479 @@ inline namespace nimata
       return static_cast<unsigned>(N_);
     }
 
-    class _worker final
+    struct _cpu final
     {
-    public:
-      ~_worker() noexcept
+      signed   _id      = -1;
+      unsigned _core    = 0;
+      unsigned _l2      = 0;
+      unsigned _l3      = 0;
+      unsigned _package = 0;
+    };
+
+    // hardware threads available to the process, sorted so that those sharing caches are adjacent
+    struct _topology final
+    {
+      std::vector<_cpu> _threads;
+      std::vector<_cpu> _cores; // first hardware thread of each physical core
+
+      static
+      auto _distance(const _cpu& a_, const _cpu& b_) noexcept -> unsigned
       {
-        _alive = false;
-        _worker_thread.join();
+        return a_._id      == b_._id      ? 0
+          :    a_._core    == b_._core    ? 1
+          :    a_._l2      == b_._l2      ? 2
+          :    a_._l3      == b_._l3      ? 3
+          :    a_._package == b_._package ? 4 : 5;
       }
+    };
+
+    // first number of files such as "3" or cpu lists such as "0-3,8-11"
+    inline
+    auto _read_first(const std::string& path_, const unsigned fallback_) -> unsigned
+    {
+      std::ifstream file(path_);
+      unsigned value;
+      return (file >> value) ? value : fallback_;
+    }
 
-      void _task(const std::function<void()>& task_) noexcept
+    inline
+    auto _read_topology(const std::vector<unsigned>& ids_, const std::string& root_) -> _topology
+    {
+      _topology topology;
+      for (const unsigned id : ids_)
       {
-        _work = task_;
-        _work_available = true;
+        const std::string path = root_ + "/cpu" + std::to_string(id);
+
+        // groups are identified by the first cpu they contain
+        _cpu cpu;
+        cpu._id      = static_cast<signed>(id);
+        cpu._core    = _read_first(path + "/topology/thread_siblings_list", id);
+        cpu._package = _read_first(path + "/topology/core_siblings_list",   cpu._core);
+        cpu._l2      = cpu._core;
+        cpu._l3      = cpu._package;
+
+        for (unsigned index = 0; ; ++index)
+        {
+          const std::string cache = path + "/cache/index" + std::to_string(index);
+
+          std::string   type;
+          std::ifstream type_file(cache + "/type");
+          if (not (type_file >> type))
+          {
+            break;
+          }
+
+          if (type == "Instruction")
+          {
+            continue;
+          }
+
+          switch (_read_first(cache + "/level", 0))
+          {
+            case 2:  cpu._l2 = _read_first(cache + "/shared_cpu_list", cpu._l2); break;
+            case 3:  cpu._l3 = _read_first(cache + "/shared_cpu_list", cpu._l3); break;
+            default: break;
+          }
+        }
+
+        topology._threads.push_back(cpu);
       }
 
-      bool _busy() const noexcept
+      std::sort(topology._threads.begin(), topology._threads.end(), [](const _cpu& a_, const _cpu& b_)
       {
-        return _work_available;
+        return a_._package != b_._package ? a_._package < b_._package
+          :    a_._l3      != b_._l3      ? a_._l3      < b_._l3
+          :    a_._l2      != b_._l2      ? a_._l2      < b_._l2
+          :    a_._core    != b_._core    ? a_._core    < b_._core
+          :    a_._id                     < b_._id;
+      });
+
+      for (const _cpu& cpu : topology._threads)
+      {
+        if (topology._cores.empty() or topology._cores.back()._core != cpu._core)
+        {
+          topology._cores.push_back(cpu);
+        }
       }
 
-    private:
-      void _loop()
+      return topology;
+    }
+
+    inline
+    auto _allowed_cpus() -> std::vector<unsigned>
+    {
+      std::vector<unsigned> ids;
+
+#   if defined(_stz_impl_AFFINITY)
+      cpu_set_t allowed;
+      CPU_ZERO(&allowed);
+      if (sched_getaffinity(0, sizeof(allowed), &allowed) == 0)
       {
-        while _stz_impl_EXPECTED(_alive)
+        for (unsigned id = 0; id < CPU_SETSIZE; ++id)
         {
-          if _stz_impl_EXPECTED(_work_available)
+          if (CPU_ISSET(id, &allowed))
           {
-            _work();
-            _work_available = false;
+            ids.push_back(id);
           }
-
-          std::this_thread::yield();
         }
       }
-      volatile bool         _alive          = true;
-      std::function<void()> _work           = nullptr;
-      std::atomic_bool      _work_available = {false};
-      std::thread           _worker_thread{_loop, this};
-    };
-    
-    template<typename Representation, typename Period>
-    constexpr
-    auto _to_ns(const std::chrono::duration<Representation, Period> duration_) -> std::chrono::nanoseconds::rep
-    {
-      return std::chrono::nanoseconds(duration_).count();
+#   endif
+      if (ids.empty())
+      {
+        for (unsigned id = 0; id < max_threads; ++id)
+        {
+          ids.push_back(id);
+        }
+      }
+
+      return ids;
     }
 
-    template<typename Type>
-    constexpr
-    auto _to_ns(const Type milliseconds_) -> std::chrono::nanoseconds::rep
+    inline
+    auto _process_topology() -> const _topology&
     {
-      return std::chrono::nanoseconds(std::chrono::milliseconds(milliseconds_)).count();
+      static const _topology topology = _read_topology(_allowed_cpus(), "/sys/devices/system/cpu");
+      return topology;
     }
 
-    template<std::chrono::nanoseconds::rep PERIOD>
-    class _cyclic_async final
+    // whether tasks of type 'Type' are work pushed by users, which an abandoned pool discards
+    template<typename Type>
+    struct _user_work : std::false_type {};
+
+    // move-only type-erased task, small callables are stored in place
+    class _task final
     {
-      static_assert(PERIOD >= 0, "stz: cyclic_async: 'PERIOD' must be greater or equal to 0.");
     public:
-      template<typename Work>
-      _cyclic_async(Work work_) noexcept
-        : _work(work_)
-      {
-        _stz_impl_DBG_LVL_3(_stz_impl_DEBUG_MESSAGE("thread spawned.");)
-      }
+      _task() noexcept = default;
 
-      _cyclic_async(const _cyclic_async&) noexcept
+      _task(std::nullptr_t) noexcept
       {}
 
-      ~_cyclic_async() noexcept
+      template<typename Callable, typename = typename std::enable_if<
+        not std::is_same<typename std::decay<Callable>::type, _task>::value
+      >::type>
+      _task(Callable&& callable_)
       {
-        _alive = false;
-        _worker_thread.join();
-        
-        _stz_impl_DBG_LVL_3(_stz_impl_DEBUG_MESSAGE("thread joined.");)
+        using Type = typename std::decay<Callable>::type;
+        _emplace<Type>(std::forward<Callable>(callable_), std::integral_constant<bool, _fits<Type>::value>());
       }
-    private:
-      inline void _loop();
-      volatile bool         _alive = true;
-      std::function<void()> _work;
-      std::thread           _worker_thread{_loop, this};
-    };
-
-    template<std::chrono::nanoseconds::rep PERIOD>
-    void _cyclic_async<PERIOD>::_loop()
-    {
-      using clock = std::conditional<
-        std::chrono::high_resolution_clock::is_steady,
-        std::chrono::high_resolution_clock,
-        std::chrono::steady_clock
-      >::type;
-
-      clock::time_point last = clock::time_point(), time;
-      std::chrono::nanoseconds::rep span;
 
-      while (_alive)
+      _task(_task&& other_) noexcept
+        : _table(other_._table)
       {
-        time = clock::now();
-        _stz_impl_GCC_CLANG_IGNORE("-Wstrict-overflow",
-        span = std::chrono::nanoseconds(time - last).count();
-        )
+        if (_table)
+        {
+          _table->_move(&_storage, &other_._storage);
+          other_._table = nullptr;
+        }
+      }
 
-        if (span >= PERIOD)
+      auto operator=(_task&& other_) noexcept -> _task&
+      {
+        if (this != &other_)
         {
-          last = time;
-          _work();
+          _reset();
+          if (other_._table)
+          {
+            _table = other_._table;
+            _table->_move(&_storage, &other_._storage);
+            other_._table = nullptr;
+          }
         }
+
+        return *this;
       }
-    }
 
-    template<>
-    inline
-    void _cyclic_async<0>::_loop()
-    {
-      while (_alive)
+      auto operator=(std::nullptr_t) noexcept -> _task&
       {
-        _work();
+        _reset();
+        return *this;
       }
-    }
 
-    template<typename Type>
-    struct _can_convert_to_bool final
-    {
-    private:
-      template<typename Type_>
-      static
-      auto _impl(int) -> decltype
-      (
-        void(static_cast<bool>(std::declval<Type_&>())),
-        std::true_type()
-      );
+      _task(const _task&) = delete;
+      auto operator=(const _task&) -> _task& = delete;
 
-      template<typename Type_>
-      static
-      auto _impl(...) -> std::false_type;
+      void operator()()
+      {
+        _table->_invoke(&_storage);
+      }
 
-    public:
-      static constexpr bool value = decltype(_impl<Type>(0))();
-    };
+      explicit operator bool() const noexcept
+      {
+        return _table != nullptr;
+      }
 
-    template<typename Type, typename Result = bool>
-    using _if_can_validate_callable = typename std::enable_if<
-      _can_convert_to_bool<Type>::value == true
-      and std::is_function<Type>::value != true, Result
-    >::type;
+      auto _discardable() const noexcept -> bool
+      {
+        return _table != nullptr and _table->_discardable;
+      }
 
-    template<typename Type, typename Result = bool>
-    using _no_can_validate_callable = typename std::enable_if<
-      _can_convert_to_bool<Type>::value != true
-      or  std::is_function<Type>::value == true, Result
-    >::type;
+      ~_task() noexcept
+      {
+        _reset();
+      }
 
-    template<typename Callable>
-    auto _validate_callable(const Callable& callable_) noexcept -> _if_can_validate_callable<Callable>
-    {
-      return static_cast<bool>(callable_);
-    }
+    private:
+      using _space = typename std::aligned_storage<4 * sizeof(void*), alignof(void*)>::type;
 
-    template<typename Callable>
-    auto _validate_callable(const Callable&) noexcept -> _no_can_validate_callable<Callable>
-    {
-      return true;
-    }
+      struct _vtable final
+      {
+        void (*_invoke)(void* storage);
+        void (*_move)(void* storage, void* from); // 'from' is left destroyed
+        void (*_destroy)(void* storage);
+        bool _discardable;
+      };
 
-    template<typename Type>
-    struct _has_iter_meths final
-    {
-    private:
-      template<typename Type_>
-      static
-      auto _impl(int) -> decltype
-      (
-        void(  std::declval<Type_&>().begin() != std::declval<Type_&>().end()),
-        void(++std::declval<Type_&>().begin()),
-        void( *std::declval<Type_&>().begin()),
-        std::true_type()
-      );
+      // stored in place only if moving it can't throw, so that queues of tasks move them around freely
+      template<typename Type>
+      struct _fits final : std::integral_constant<bool,
+        sizeof(Type) <= sizeof(_space)
+        and alignof(_space) % alignof(Type) == 0
+        and std::is_nothrow_move_constructible<Type>::value
+      > {};
 
-      template<typename Type_>
-      static
-      auto _impl(...) -> std::false_type;
+      template<typename Type>
+      struct _inside final
+      {
+        static void _invoke(void* const storage_)
+        {
+          (*static_cast<Type*>(storage_))();
+        }
 
-    public:
-      static constexpr bool value = decltype(_impl<Type>(0))();
-    };
+        static void _move(void* const storage_, void* const from_)
+        {
+          new(storage_) Type(std::move(*static_cast<Type*>(from_)));
+          static_cast<Type*>(from_)->~Type();
+        }
 
-    template<typename Type>
-    struct _has_iter_funcs final
-    {
-    private:
-      template<typename Type_>
-      static
-      auto _impl(int) -> decltype
-      (
-        void(  begin(std::declval<Type_&>()) != end(std::declval<Type_&>())),
-        void(++begin(std::declval<Type_&>())),
-        void( *begin(std::declval<Type_&>())),
-        std::true_type()
-      );
+        static void _destroy(void* const storage_)
+        {
+          static_cast<Type*>(storage_)->~Type();
+        }
 
-      template<typename Type_>
+        static constexpr _vtable _table = {&_invoke, &_move, &_destroy, _user_work<Type>::value};
+      };
+
+      template<typename Type>
+      struct _outside final
+      {
+        static void _invoke(void* const storage_)
+        {
+          (**static_cast<Type**>(storage_))();
+        }
+
+        static void _move(void* const storage_, void* const from_)
+        {
+          *static_cast<Type**>(storage_) = *static_cast<Type**>(from_);
+        }
+
+        static void _destroy(void* const storage_)
+        {
+          delete *static_cast<Type**>(storage_);
+        }
+
+        static constexpr _vtable _table = {&_invoke, &_move, &_destroy, _user_work<Type>::value};
+      };
+
+      template<typename Type, typename Callable>
+      void _emplace(Callable&& callable_, std::true_type)
+      {
+        new(&_storage) Type(std::forward<Callable>(callable_));
+        _table = &_inside<Type>::_table;
+      }
+
+      template<typename Type, typename Callable>
+      void _emplace(Callable&& callable_, std::false_type)
+      {
+        *reinterpret_cast<Type**>(&_storage) = new Type(std::forward<Callable>(callable_));
+        _table = &_outside<Type>::_table;
+      }
+
+      void _reset() noexcept
+      {
+        if (_table)
+        {
+          _table->_destroy(&_storage);
+          _table = nullptr;
+        }
+      }
+      const _vtable* _table = nullptr;
+      _space         _storage;
+    };
+
+#   if __cplusplus < 201703L
+    template<typename Type>
+    constexpr _task::_vtable _task::_inside<Type>::_table;
+
+    template<typename Type>
+    constexpr _task::_vtable _task::_outside<Type>::_table;
+#   endif
+
+    constexpr size_t _cache_line = 64;
+
+    struct _front;
+
+    struct _identity final
+    {
+      const void*       _arena   = nullptr;
+      signed            _index   = -1;
+      std::atomic_uint* _blocked = nullptr; // workers of the arena that are in a blocking region
+      _front*           _origin  = nullptr; // pool whose batch is running
+      unsigned          _depth   = 0;       // nesting of blocking regions
+    };
+
+    inline
+    auto _this_worker() noexcept -> _identity&
+    {
+      static thread_local _identity identity;
+      return identity;
+    }
+
+    // tasks collected on behalf of a producer
+    struct _buffer final
+    {
+      const Pool* const  _pool;
+      const size_t       _capacity;
+      std::vector<_task> _tasks;
+    };
+
+    // buffer that the calling thread's pushes currently go to
+    inline
+    auto _collector() noexcept -> _buffer*&
+    {
+      static thread_local _buffer* buffer = nullptr;
+      return buffer;
+    }
+
+    // a pool's queue as seen by the arena servicing it
+    struct _front final
+    {
+      void _push(_task&& task_)
+      {
+        std::lock_guard<std::mutex> lock{_queue_mtx};
+        ++_pending;
+        _queue.push(std::move(task_));
+      }
+
+      // 'tasks' are moved from
+      void _push(std::vector<_task>& tasks_)
+      {
+        std::lock_guard<std::mutex> lock{_queue_mtx};
+        _pending += tasks_.size();
+        for (_task& task : tasks_)
+        {
+          _queue.push(std::move(task));
+        }
+      }
+
+      // 'task' is only moved from if there is room for it
+      bool _try_push(_task& task_, const size_t capacity_)
+      {
+        std::lock_guard<std::mutex> lock{_queue_mtx};
+        if (_queue.size() >= capacity_)
+        {
+          return false;
+        }
+
+        ++_pending;
+        _queue.push(std::move(task_));
+        return true;
+      }
+
+      // discarded tasks are destroyed once the queue is unlocked
+      void _push_dropping(_task&& task_, const size_t capacity_)
+      {
+        std::vector<_task> dropped;
+        {
+          std::lock_guard<std::mutex> lock{_queue_mtx};
+          for (; _queue.size() >= capacity_; --_pending)
+          {
+            dropped.push_back(std::move(_queue.front()));
+            _queue.pop();
+          }
+
+          ++_pending;
+          _queue.push(std::move(task_));
+        }
+      }
+
+      // run the oldest queued task on the calling thread unless the pool is paused, false if none was run
+      bool _help()
+      {
+        _task task;
+        {
+          std::lock_guard<std::mutex> lock{_queue_mtx};
+          if (_queue.empty() or _active == false)
+          {
+            return false;
+          }
+
+          task = std::move(_queue.front());
+          _queue.pop();
+        }
+
+        task();
+        --_pending;
+        return true;
+      }
+
+      // moves the queued work pushed by users to 'dropped', other tasks stay queued in order
+      void _discard(std::vector<_task>& dropped_)
+      {
+        std::lock_guard<std::mutex> lock{_queue_mtx};
+        for (size_t k = _queue.size(); k != 0; --k)
+        {
+          if (_queue.front()._discardable())
+          {
+            dropped_.push_back(std::move(_queue.front()));
+            --_pending;
+          }
+          else
+          {
+            _queue.push(std::move(_queue.front()));
+          }
+          _queue.pop();
+        }
+      }
+
+      std::atomic_size_t    _capacity   = {0}; // 0 is unbounded
+      std::atomic<Overflow> _overflow   = {Overflow::block};
+      std::atomic_uint      _cost       = {100000}; // moving average of the duration of a task, in nanoseconds
+      std::atomic_bool      _fibered    = {false};
+      std::atomic_uint      _abandoning = {0}; // calls to 'abandon' in progress
+      std::atomic_size_t    _dropped    = {0}; // tasks of lined up batches that workers discarded meanwhile
+      std::atomic_bool    _active  = {true};
+      std::atomic_uint    _limit   = {1};
+      std::atomic_uint    _running = {0};
+      std::atomic_size_t  _pending = {0};
+      unsigned            _last    = 0; // worker that was last assigned work from the queue
+      mutable std::mutex  _queue_mtx;
+      std::queue<_task>   _queue;
+    };
+
+    // thread whose stack size can be chosen
+    class _thread final
+    {
+    public:
+      template<typename Type, void (Type::*method)()>
+      bool _start(Type* const object_, const size_t stack_size_, const signed cpu_ = -1) noexcept
+      {
+#   if defined(_stz_impl_PTHREAD)
+        pthread_attr_t attributes;
+        pthread_attr_init(&attributes);
+
+        if (stack_size_ != 0)
+        {
+          const size_t minimum = PTHREAD_STACK_MIN;
+          pthread_attr_setstacksize(&attributes, stack_size_ < minimum ? minimum : stack_size_);
+        }
+
+#   if defined(_stz_impl_AFFINITY)
+        if (cpu_ >= 0)
+        {
+          cpu_set_t bound;
+          CPU_ZERO(&bound);
+          CPU_SET(static_cast<unsigned>(cpu_), &bound);
+          pthread_attr_setaffinity_np(&attributes, sizeof(bound), &bound);
+        }
+#   endif
+
+        _joinable = pthread_create(&_handle, &attributes, _trampoline<Type, method>, object_) == 0;
+        pthread_attr_destroy(&attributes);
+#   else
+        _handle   = std::thread(method, object_);
+        _joinable = true;
+#   endif
+        if _stz_impl_ABNORMAL(_joinable == false)
+        {
+          _stz_impl_DBG_LVL_0(_stz_impl_DEBUG_MESSAGE("thread could not be spawned.");)
+        }
+
+        return _joinable;
+      }
+
+      bool _started() const noexcept
+      {
+        return _joinable;
+      }
+
+      void _join() noexcept
+      {
+        if (_joinable)
+        {
+#   if defined(_stz_impl_PTHREAD)
+          pthread_join(_handle, nullptr);
+#   else
+          _handle.join();
+#   endif
+          _joinable = false;
+        }
+      }
+
+    private:
+#   if defined(_stz_impl_PTHREAD)
+      template<typename Type, void (Type::*method)()>
       static
-      auto _impl(...) -> std::false_type;
+      void* _trampoline(void* const object_)
+      {
+        (static_cast<Type*>(object_)->*method)();
+        return nullptr;
+      }
+      pthread_t   _handle;
+#   else
+      std::thread _handle;
+#   endif
+      std::atomic_bool _joinable = {false};
+    };
+
+    // batch of tasks handed to a worker in one go
+    struct _slot final
+    {
+      // most tasks a worker is handed at once
+      static constexpr unsigned _capacity = 64;
+
+      _task    _batch[_capacity];
+      unsigned _count  = 0;
+      _front*  _origin = nullptr;
+      char     _padding[_cache_line];
+    };
 
+    // the assignation thread and the worker each write to their own cache line, a handoff is a single release-store
+    class _worker final
+    {
     public:
-      static constexpr bool value = decltype(_impl<Type>(0))();
+      _identity             _self;
+      _cpu                  _place;      // hardware thread the worker is bound to, if any
+      std::vector<unsigned> _neighbours; // workers sorted by cache distance, itself first
+
+      ~_worker() noexcept
+      {
+        _alive = false;
+        _worker_thread._join();
+      }
+
+      void _start(const size_t stack_size_) noexcept
+      {
+        _worker_thread._start<_worker, &_worker::_loop>(this, stack_size_, _place._id);
+      }
+
+      bool _spawned() const noexcept
+      {
+        return _worker_thread._started();
+      }
+
+      // join the thread, it can be started again afterwards
+      void _retire() noexcept
+      {
+        _alive = false;
+        _worker_thread._join();
+        _alive = true;
+      }
+
+      // single-producer single-consumer mailbox, a second slot lets the next batch wait while one runs
+      static constexpr unsigned _slots = 2;
+
+      // batches handed over but not yet completed
+      auto _backlog() const noexcept -> unsigned
+      {
+        return _tail.load(std::memory_order_relaxed) - _head.load(std::memory_order_acquire);
+      }
+
+      bool _idle() const noexcept
+      {
+        return _worker_thread._started() and _backlog() == 0;
+      }
+
+      // the worker is running a batch from 'origin' and has nothing lined up after it
+      bool _follows(const _front* const origin_) const noexcept
+      {
+        return _latest == origin_ and _backlog() == 1;
+      }
+
+      // hand over the first 'count' tasks of 'queue', which comes from 'origin'
+      void _give(std::queue<_task>& queue_, const unsigned count_, _front* const origin_) noexcept
+      {
+        const unsigned tail = _tail.load(std::memory_order_relaxed);
+        _slot& slot = _mailbox[tail % _slots];
+
+        for (unsigned k = 0; k < count_; ++k)
+        {
+          slot._batch[k] = std::move(queue_.front());
+          queue_.pop();
+        }
+
+        slot._count  = count_;
+        slot._origin = origin_;
+        _latest      = origin_;
+        _tail.store(tail + 1, std::memory_order_release);
+      }
+
+      bool _busy() const noexcept
+      {
+        return _backlog() != 0;
+      }
+
+    private:
+      void _loop()
+      {
+        while _stz_impl_EXPECTED(_alive)
+        {
+          const unsigned head = _head.load(std::memory_order_relaxed);
+          if _stz_impl_EXPECTED(head != _tail.load(std::memory_order_acquire))
+          {
+            _slot& slot = _mailbox[head % _slots];
+            _front* const origin = slot._origin;
+
+            _this_worker() = _self;
+            _this_worker()._origin = origin;
+            const unsigned count = slot._count;
+
+            // a batch lined up before its pool was abandoned is discarded like the pool's queue once it starts
+            const bool abandoned = origin->_abandoning.load(std::memory_order_relaxed) != 0;
+            unsigned   dropped   = 0;
+
+            // the pool's counters are shared by every worker, they are updated once per batch rather than per task
+            const auto start = std::chrono::steady_clock::now();
+            for (unsigned k = 0; k < count; ++k)
+            {
+              if _stz_impl_ABNORMAL(abandoned and slot._batch[k]._discardable())
+              {
+                ++dropped;
+              }
+              else
+              {
+                slot._batch[k]();
+              }
+              slot._batch[k] = nullptr;
+            }
+            const auto elapsed = std::chrono::steady_clock::now() - start;
+
+            // the batch size handed out by the arena follows the average duration of the pool's tasks
+            if _stz_impl_EXPECTED(dropped == 0)
+            {
+              const auto sample = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count() / count;
+              const unsigned cost = origin->_cost.load(std::memory_order_relaxed);
+              origin->_cost.store(static_cast<unsigned>((cost * 7ull + static_cast<unsigned long long>(sample)) / 8),
+                std::memory_order_relaxed);
+            }
+            else
+            {
+              origin->_dropped += dropped;
+            }
+
+            --origin->_running;
+            origin->_pending -= count;
+            _head.store(head + 1, std::memory_order_release);
+            continue;
+          }
+
+          std::this_thread::yield();
+        }
+      }
+      std::atomic_bool      _alive  = {true};
+      _thread               _worker_thread;
+      char                  _padding_0[_cache_line];
+      std::atomic_uint      _head   = {0}; // written by the worker only
+      char                  _padding_1[_cache_line - sizeof(std::atomic_uint)];
+      std::atomic_uint      _tail   = {0}; // written by the assignation thread only
+      _front*               _latest = nullptr;
+      char                  _padding_2[_cache_line - sizeof(std::atomic_uint) - sizeof(_front*)];
+      _slot                 _mailbox[_slots];
     };
 
+    // 'N' workers followed by as many spares that stand in for workers in a blocking region
+    inline
+    auto _recruit(const unsigned N_, const void* const arena_, std::atomic_uint* const blocked_,
+      const Placement placement_) noexcept -> _worker*
+    {
+      _worker* const workers = new _worker[2 * N_];
+
+      for (unsigned k = 0; k < 2 * N_; ++k)
+      {
+        workers[k]._self._arena   = arena_;
+        workers[k]._self._index   = static_cast<signed>(k);
+        workers[k]._self._blocked = blocked_;
+      }
+
+      for (unsigned k = 0; k < N_; ++k)
+      {
+        if (placement_ == Placement::physical_cores)
+        {
+          const std::vector<_cpu>& cores = _process_topology()._cores;
+          workers[k]._place = cores[k % cores.size()];
+        }
+      }
+
+      for (unsigned k = 0; k < N_; ++k)
+      {
+        std::vector<unsigned>& neighbours = workers[k]._neighbours;
+
+        // ties are broken by rotating from the worker itself so that load spreads evenly
+        for (unsigned n = 0; n < N_; ++n)
+        {
+          neighbours.push_back((k + n) % N_);
+        }
+
+        std::stable_sort(neighbours.begin(), neighbours.end(), [&](const unsigned a_, const unsigned b_)
+        {
+          return (a_ == k ? 0 : _topology::_distance(workers[k]._place, workers[a_]._place))
+            <    (b_ == k ? 0 : _topology::_distance(workers[k]._place, workers[b_]._place));
+        });
+      }
+
+      return workers;
+    }
+    
+    template<typename Representation, typename Period>
+    constexpr
+    auto _to_ns(const std::chrono::duration<Representation, Period> duration_) -> std::chrono::nanoseconds::rep
+    {
+      return std::chrono::nanoseconds(duration_).count();
+    }
+
     template<typename Type>
-    struct _is_iterable final
+    constexpr
+    auto _to_ns(const Type milliseconds_) -> std::chrono::nanoseconds::rep
+    {
+      return std::chrono::nanoseconds(std::chrono::milliseconds(milliseconds_)).count();
+    }
+
+    template<std::chrono::nanoseconds::rep PERIOD>
+    class _cyclic_async final
     {
+      static_assert(PERIOD >= 0, "stz: cyclic_async: 'PERIOD' must be greater or equal to 0.");
     public:
-      static constexpr bool value =
-           _has_iter_funcs<Type>::value
-        || _has_iter_meths<Type>::value
-        || std::is_pointer<Type>::value;
-    };
+      template<typename Work>
+      _cyclic_async(Work work_) noexcept
+        : _work(work_)
+      {
+        _stz_impl_DBG_LVL_3(_stz_impl_DEBUG_MESSAGE("thread spawned.");)
+      }
+
+      _cyclic_async(const _cyclic_async&) noexcept
+      {}
+
+      ~_cyclic_async() noexcept
+      {
+        _alive = false;
+        _worker_thread.join();
+        
+        _stz_impl_DBG_LVL_3(_stz_impl_DEBUG_MESSAGE("thread joined.");)
+      }
+    private:
+      inline void _loop();
+      volatile bool         _alive = true;
+      std::function<void()> _work;
+      std::thread           _worker_thread{&_cyclic_async::_loop, this};
+    };
+
+    template<std::chrono::nanoseconds::rep PERIOD>
+    void _cyclic_async<PERIOD>::_loop()
+    {
+      using clock = std::conditional<
+        std::chrono::high_resolution_clock::is_steady,
+        std::chrono::high_resolution_clock,
+        std::chrono::steady_clock
+      >::type;
+
+      clock::time_point last = clock::time_point(), time;
+      std::chrono::nanoseconds::rep span;
+
+      while (_alive)
+      {
+        time = clock::now();
+        _stz_impl_GCC_CLANG_IGNORE("-Wstrict-overflow",
+        span = std::chrono::nanoseconds(time - last).count();
+        )
+
+        if (span >= PERIOD)
+        {
+          last = time;
+          _work();
+        }
+      }
+    }
+
+    template<>
+    inline
+    void _cyclic_async<0>::_loop()
+    {
+      while (_alive)
+      {
+        _work();
+      }
+    }
+
+    template<typename Type>
+    struct _can_convert_to_bool final
+    {
+    private:
+      template<typename Type_>
+      static
+      auto _impl(int) -> decltype
+      (
+        void(static_cast<bool>(std::declval<Type_&>())),
+        std::true_type()
+      );
+
+      template<typename Type_>
+      static
+      auto _impl(...) -> std::false_type;
+
+    public:
+      static constexpr bool value = decltype(_impl<Type>(0))();
+    };
+
+    template<typename Type, typename Result = bool>
+    using _if_can_validate_callable = typename std::enable_if<
+      _can_convert_to_bool<Type>::value == true
+      and std::is_function<Type>::value != true, Result
+    >::type;
+
+    template<typename Type, typename Result = bool>
+    using _no_can_validate_callable = typename std::enable_if<
+      _can_convert_to_bool<Type>::value != true
+      or  std::is_function<Type>::value == true, Result
+    >::type;
+
+    template<typename Callable>
+    auto _validate_callable(const Callable& callable_) noexcept -> _if_can_validate_callable<Callable>
+    {
+      return static_cast<bool>(callable_);
+    }
+
+    template<typename Callable>
+    auto _validate_callable(const Callable&) noexcept -> _no_can_validate_callable<Callable>
+    {
+      return true;
+    }
+
+    template<typename Type>
+    struct _has_iter_meths final
+    {
+    private:
+      template<typename Type_>
+      static
+      auto _impl(int) -> decltype
+      (
+        void(  std::declval<Type_&>().begin() != std::declval<Type_&>().end()),
+        void(++std::declval<Type_&>().begin()),
+        void( *std::declval<Type_&>().begin()),
+        std::true_type()
+      );
+
+      template<typename Type_>
+      static
+      auto _impl(...) -> std::false_type;
+
+    public:
+      static constexpr bool value = decltype(_impl<Type>(0))();
+    };
+
+    template<typename Type>
+    struct _has_iter_funcs final
+    {
+    private:
+      template<typename Type_>
+      static
+      auto _impl(int) -> decltype
+      (
+        void(  begin(std::declval<Type_&>()) != end(std::declval<Type_&>())),
+        void(++begin(std::declval<Type_&>())),
+        void( *begin(std::declval<Type_&>())),
+        std::true_type()
+      );
+
+      template<typename Type_>
+      static
+      auto _impl(...) -> std::false_type;
+
+    public:
+      static constexpr bool value = decltype(_impl<Type>(0))();
+    };
+
+    template<typename Type>
+    struct _is_iterable final
+    {
+    public:
+      static constexpr bool value =
+           _has_iter_funcs<Type>::value
+        || _has_iter_meths<Type>::value
+        || std::is_pointer<Type>::value;
+    };
+
+    template<typename Type>
+    using _if_iterable = typename std::enable_if<_is_iterable<Type>::value>::type;
+
+    template<typename Type>
+    auto _begin(Type&& iterable_) noexcept -> typename std::enable_if<
+      _has_iter_meths<Type>::value and not _has_iter_funcs<Type>::value,
+      decltype(std::declval<Type&>().begin())
+    >::type
+    {
+      return iterable_.begin();
+    }
+
+    template<typename Type>
+    auto _begin(Type&& iterable_) noexcept -> typename std::enable_if<
+      _has_iter_funcs<Type>::value,
+      decltype(begin(std::declval<Type&>()))
+    >::type
+    {
+      return begin(std::forward<Type>(iterable_));
+    }
+
+    template<typename Type>
+    auto _end(Type&& iterable_) noexcept -> typename std::enable_if<
+      _has_iter_meths<Type>::value and not _has_iter_funcs<Type>::value,
+      decltype(std::declval<Type&>().end())
+    >::type
+    {
+      return iterable_.end();
+    }
+
+    template<typename Type>
+    auto _end(Type&& iterable_) noexcept -> typename std::enable_if<
+      _has_iter_funcs<Type>::value,
+      decltype(end(std::declval<Type&>()))
+    >::type
+    {
+      return end(std::forward<Type>(iterable_));
+    }
+
+    template<typename Type>
+    auto _begin(Type* pointer_) noexcept -> Type*
+    {
+      return pointer_;
+    }
+
+    template<typename Type>
+    auto _end(Type* pointer_) noexcept -> Type*
+    {
+      return pointer_;
+    }
+
+    template<typename Type, bool = _is_iterable<Type>::value>
+    struct _iter_type;
+
+    template<typename Type>
+    struct _iter_type<Type, true> final
+    {
+      using iter = decltype( _begin(std::declval<Type&>()));
+      using type = decltype(*_begin(std::declval<Type&>()));
+
+      static
+      type _deref(iter& data) noexcept
+      {
+        return *data;
+      }
+
+      static
+      const type _deref(const iter& data) noexcept
+      {
+        return *data;
+      }
+    };
+
+    template<typename Type>
+    struct _iter_type<Type, false> final
+    {
+      using iter = Type;
+      using type = Type;
+
+      static
+      type _deref(const iter data) noexcept
+      {
+        return data;
+      }
+    };
+
+    // result of calling a stored callable with its stored arguments moved in, as std::thread does
+    template<typename Callable, typename... Arguments>
+    using _result = decltype(std::declval<typename std::decay<Callable>::type&>()(
+      std::declval<typename std::decay<Arguments>::type>()...));
+
+    template<size_t...>
+    struct _indices final
+    {};
+
+    template<size_t N, size_t... I>
+    struct _make_indices
+    {
+      using type = typename _make_indices<N - 1, N - 1, I...>::type;
+    };
+
+    template<size_t... I>
+    struct _make_indices<0, I...>
+    {
+      using type = _indices<I...>;
+    };
+
+    // callable and arguments moved into a task instead of being copied, the arguments are moved into the call
+    template<typename Callable, typename... Arguments>
+    class _bound final
+    {
+    public:
+      template<typename Callable_, typename... Arguments_>
+      explicit _bound(std::piecewise_construct_t, Callable_&& callable_, Arguments_&&... arguments_)
+        : _callable(std::forward<Callable_>(callable_))
+        , _arguments(std::forward<Arguments_>(arguments_)...)
+      {}
+
+      auto operator()() -> _result<Callable, Arguments...>
+      {
+        return _call(typename _make_indices<sizeof...(Arguments)>::type());
+      }
+
+    private:
+      template<size_t... I>
+      auto _call(_indices<I...>) -> _result<Callable, Arguments...>
+      {
+        return _callable(std::move(std::get<I>(_arguments))...);
+      }
+      Callable                 _callable;
+      std::tuple<Arguments...> _arguments;
+    };
+
+    template<typename Callable, typename... Arguments>
+    struct _user_work<_bound<Callable, Arguments...>> : std::true_type {};
+
+    template<typename Callable, typename... Arguments>
+    using _binding = _bound<typename std::decay<Callable>::type, typename std::decay<Arguments>::type...>;
+
+    template<typename Callable, typename... Arguments>
+    auto _bind(Callable&& callable_, Arguments&&... arguments_) -> _binding<Callable, Arguments...>
+    {
+      return _binding<Callable, Arguments...>(
+        std::piecewise_construct, std::forward<Callable>(callable_), std::forward<Arguments>(arguments_)...);
+    }
+
+    // sets the promise of a bound task, a task dropped before running breaks its promise
+    template<typename Result, typename Bound>
+    struct _promised final
+    {
+      void operator()()
+      {
+        _promise.set_value(_work());
+      }
+      std::promise<Result> _promise;
+      Bound                _work;
+    };
+
+    template<typename Bound>
+    struct _promised<void, Bound> final
+    {
+      void operator()()
+      {
+        _work();
+        _promise.set_value();
+      }
+      std::promise<void> _promise;
+      Bound              _work;
+    };
+
+    template<typename Result, typename Bound>
+    struct _user_work<_promised<Result, Bound>> : std::true_type {};
+
+    template<typename Callable, typename... Arguments>
+    using _auto = typename std::conditional<
+      std::is_same<_result<Callable, Arguments...>, void>::value,
+      void,
+      std::future<_result<Callable, Arguments...>>
+    >::type;
+
+    template<typename Callable, typename... Arguments>
+    using _future = typename std::future<_result<Callable, Arguments...>>;
+
+    template<Tracking tracking, typename Callable, typename... Arguments>
+    using _tracking = 
+      typename std::conditional<tracking == Tracking::stray,
+        void,
+        typename std::conditional<tracking == Tracking::bound,
+          std::future<_result<Callable, Arguments...>>,
+          typename std::conditional<tracking == Tracking::chained,
+            Future<_result<Callable, Arguments...>>,
+            typename std::conditional<std::is_same<_result<Callable, Arguments...>, void>::value,
+              void,
+              std::future<_result<Callable, Arguments...>>
+            >::type
+          >::type
+        >::type
+      >::type;
+
+    using _attached = std::integral_constant<Tracking, Tracking::bound>;
+    using _detached = std::integral_constant<Tracking, Tracking::stray>;
+    using _chaining = std::integral_constant<Tracking, Tracking::chained>;
+    using _inferred = std::integral_constant<Tracking, Tracking::infer>;
+
+    // shared state of a Future, its whole life cycle is encoded in a single atomic word
+    class _state_base
+    {
+    public:
+      static constexpr uintptr_t _empty = 0; // any other value is the continuation to run once ready
+      static constexpr uintptr_t _ready = 1;
+
+      bool _is_ready() const noexcept
+      {
+        return _word.load(std::memory_order_acquire) == _ready;
+      }
+
+      // whether the producer was discarded instead of setting the value
+      bool _is_broken() const noexcept
+      {
+        return _is_ready() and _broken;
+      }
+
+      void _break() noexcept
+      {
+        _broken = true;
+        _publish();
+      }
+
+      // 'continuation' runs on the thread that sets the value, false is returned if it is already set
+      bool _suspend(_task* const continuation_) noexcept
+      {
+        uintptr_t expected = _word.load(std::memory_order_acquire);
+
+        while (expected != _ready)
+        {
+          // continuations already waiting run first
+          _task* const previous = reinterpret_cast<_task*>(expected);
+          _task* const combined = expected == _empty ? continuation_ : new _task([previous, continuation_]{
+            (*previous)(),     delete previous;
+            (*continuation_)(), delete continuation_;
+          });
+
+          if (_word.compare_exchange_weak(expected, reinterpret_cast<uintptr_t>(combined),
+            std::memory_order_acq_rel, std::memory_order_acquire))
+          {
+            return true;
+          }
+
+          if (combined != continuation_)
+          {
+            delete combined;
+          }
+        }
+
+        return false;
+      }
+
+      // 'continuation' runs on the thread that sets the value, or right away if it is already set
+      void _then(_task* const continuation_) noexcept
+      {
+        if (_suspend(continuation_) == false)
+        {
+          (*continuation_)();
+          delete continuation_;
+        }
+      }
+
+    protected:
+      void _publish() noexcept
+      {
+        const uintptr_t previous = _word.exchange(_ready, std::memory_order_acq_rel);
+
+        if (previous != _empty)
+        {
+          _task* const continuation = reinterpret_cast<_task*>(previous);
+          (*continuation)();
+          delete continuation;
+        }
+      }
+      std::atomic<uintptr_t> _word   = {_empty};
+      bool                   _broken = false; // published along with '_word'
+    };
+
+    template<typename Type>
+    class _state final : public _state_base
+    {
+    public:
+      template<typename... Arguments>
+      void _set(Arguments&&... arguments_) noexcept
+      {
+        new(&_storage) Type(std::forward<Arguments>(arguments_)...);
+        _publish();
+      }
+
+      auto _value() noexcept -> Type&
+      {
+        return *reinterpret_cast<Type*>(&_storage);
+      }
+
+      void _release() noexcept
+      {
+        if (_references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+          delete this;
+        }
+      }
+
+      ~_state() noexcept
+      {
+        if (_is_ready() and _broken == false)
+        {
+          _value().~Type();
+        }
+      }
+
+    private:
+      std::atomic_uint _references = {2}; // producer and future
+      typename std::aligned_storage<sizeof(Type), alignof(Type)>::type _storage;
+    };
+
+    // 'void' is stored as an empty value
+    struct _none final
+    {};
+
+    template<typename Type>
+    using _stored = typename std::conditional<std::is_void<Type>::value, _none, Type>::type;
+
+    template<typename Result>
+    struct _fulfil final
+    {
+      template<typename Callable, typename... Arguments>
+      static
+      void _impl(_state<Result>* const state_, Callable& callable_, Arguments&&... arguments_)
+      {
+        state_->_set(callable_(std::forward<Arguments>(arguments_)...));
+        state_->_release();
+      }
+    };
+
+    template<>
+    struct _fulfil<void> final
+    {
+      template<typename Callable, typename... Arguments>
+      static
+      void _impl(_state<_none>* const state_, Callable& callable_, Arguments&&... arguments_)
+      {
+        callable_(std::forward<Arguments>(arguments_)...);
+        state_->_set();
+        state_->_release();
+      }
+    };
+
+    // fulfils the shared state of a chained task, a task dropped before running breaks its state
+    template<typename Result, typename Bound>
+    struct _chained final
+    {
+      _chained(_state<_stored<Result>>* const target_, Bound&& work_)
+        noexcept(std::is_nothrow_move_constructible<Bound>::value)
+        : _target(target_)
+        , _work(std::move(work_))
+      {}
+
+      _chained(_chained&& other_) noexcept(std::is_nothrow_move_constructible<Bound>::value)
+        : _target(other_._target)
+        , _work(std::move(other_._work))
+      {
+        other_._target = nullptr;
+      }
+
+      void operator()()
+      {
+        _state<_stored<Result>>* const target = _target;
+        _target = nullptr;
+        _fulfil<Result>::_impl(target, _work);
+      }
+
+      ~_chained() noexcept
+      {
+        if (_target != nullptr)
+        {
+          _target->_break();
+          _target->_release();
+        }
+      }
+
+      _state<_stored<Result>>* _target;
+      Bound                    _work;
+    };
+
+    template<typename Result, typename Bound>
+    struct _user_work<_chained<Result, Bound>> : std::true_type {};
+
+    // result of a continuation given the result of its predecessor
+    template<typename Callable, typename Type>
+    struct _next final
+    {
+      using type = decltype(std::declval<Callable&>()(std::declval<Type>()));
+
+      static
+      void _impl(_state<_stored<type>>* const next_, Callable& callable_, _state<Type>* const state_)
+      {
+        _fulfil<type>::_impl(next_, callable_, std::move(state_->_value()));
+      }
+    };
+
+    template<typename Callable>
+    struct _next<Callable, _none> final
+    {
+      using type = decltype(std::declval<Callable&>()());
+
+      static
+      void _impl(_state<_stored<type>>* const next_, Callable& callable_, _state<_none>*)
+      {
+        _fulfil<type>::_impl(next_, callable_);
+      }
+    };
+
+    template<typename Type>
+    struct _parfor;
+
+    template<typename Result>
+    struct _push;
+
+    struct _strand final
+    {
+      const size_t      _key;
+      std::atomic_uint  _references = {0}; // handles, pushes in progress and the drain if scheduled
+      std::mutex        _queue_mtx;
+      std::queue<_task> _queue;
+      bool              _scheduled  = false;
+
+      explicit _strand(const size_t key_) noexcept : _key(key_) {}
+    };
+
+    // strands by key, sharded so that unrelated keys seldom contend
+    class _strands final
+    {
+    public:
+      auto _acquire(const size_t key_) noexcept -> _strand*
+      {
+        _shard& shard = _shards[key_ % _count];
+        std::lock_guard<std::mutex> lock(shard._mtx);
+
+        _strand*& strand = shard._map[key_];
+        if (strand == nullptr)
+        {
+          strand = new _strand(key_);
+        }
+
+        ++strand->_references;
+
+        return strand;
+      }
+
+      // the strand is forgotten once nothing refers to it, a strand acquired again meanwhile is kept
+      void _release(_strand* const strand_) noexcept
+      {
+        const size_t key = strand_->_key;
+
+        if (--strand_->_references != 0)
+        {
+          return;
+        }
+
+        _shard& shard = _shards[key % _count];
+        std::lock_guard<std::mutex> lock(shard._mtx);
+
+        const auto found = shard._map.find(key);
+        if ((found != shard._map.end()) and (found->second->_references == 0))
+        {
+          delete found->second;
+          shard._map.erase(found);
+        }
+      }
+
+      // moves the queued work pushed by users to 'dropped', a strand's drain still runs and finds it gone
+      void _discard(std::vector<_task>& dropped_) noexcept
+      {
+        for (_shard& shard : _shards)
+        {
+          std::lock_guard<std::mutex> lock(shard._mtx);
+          for (const std::pair<const size_t, _strand*>& entry : shard._map)
+          {
+            std::lock_guard<std::mutex> queue_lock(entry.second->_queue_mtx);
+            std::queue<_task>& queue = entry.second->_queue;
+            for (size_t k = queue.size(); k != 0; --k)
+            {
+              if (queue.front()._discardable())
+              {
+                dropped_.push_back(std::move(queue.front()));
+              }
+              else
+              {
+                queue.push(std::move(queue.front()));
+              }
+              queue.pop();
+            }
+          }
+        }
+      }
+
+    private:
+      static constexpr unsigned _count = 16;
+      struct _shard final
+      {
+        std::mutex                            _mtx;
+        std::unordered_map<size_t, _strand*> _map;
+      };
+      _shard _shards[_count];
+    };
+
+    struct _combine;
+
+    template<typename Type>
+    class _pipe;
+
+    class _wheel;
+
+#   if defined(_stz_impl_FIBERS)
+    class _fiber;
+#   endif
+
+#   if defined(_stz_impl_COROUTINES)
+    struct _schedule final
+    {
+      Pool* const _pool;
+
+      bool await_ready() const noexcept
+      {
+        return false;
+      }
+
+      inline void await_suspend(std::coroutine_handle<> coroutine) const noexcept;
+
+      void await_resume() const noexcept
+      {}
+    };
+#   endif
+  }
+//*///------------------------------------------------------------------------------------------------------------------
+  class Arena
+  {
+  public:
+    // constructs arena, workers are spawned asynchronously by the assignation thread
+    inline Arena(signed number_of_threads = max_threads, size_t stack_size = default_stack_size) noexcept;
+
+    // constructs arena, deferring the spawning of threads as specified by 'startup'
+    inline Arena(Startup startup, signed number_of_threads = max_threads, size_t stack_size = default_stack_size) noexcept;
+
+    // constructs arena whose size and worker placement follow the cpu topology
+    inline Arena(Placement placement, Startup startup = eager, size_t stack_size = default_stack_size) noexcept;
+
+    // get amount of workers
+    inline auto size() const noexcept -> unsigned;
+
+    // get stack size of workers
+    inline auto stack_size() const noexcept -> size_t;
+
+    // set amount of workers
+    inline void size(signed number_of_threads) noexcept;
+
+    // join threads, pools using the arena must be destroyed beforehand
+    inline ~Arena() noexcept;
+
+  private:
+    friend class Pool;
+    template<typename> friend struct _nimata_impl::_parfor;
+    inline void _attach(_nimata_impl::_front* front) noexcept;
+    inline void _detach(_nimata_impl::_front* front) noexcept;
+    inline void _launch() noexcept;
+    inline void _assign() noexcept;
+    inline auto _nearest_idle(unsigned worker) const noexcept -> signed;
+    inline auto _nearest_follower(const _nimata_impl::_front& front) const noexcept -> signed;
+    inline auto _spare() noexcept -> signed;
+    inline void _retire_spares() noexcept;
+    inline auto _capacity() const noexcept -> unsigned;
+    inline auto _batch_size(const _nimata_impl::_front& front) const noexcept -> unsigned;
+    static constexpr unsigned _span = 50000; // nanoseconds a batch should keep a worker busy for
+    inline Arena(Startup startup, Placement placement, signed number_of_threads, size_t stack_size) noexcept;
+    std::atomic_bool                    _alive    = {true};
+    std::atomic_bool                    _launched = {false};
+    std::mutex                          _launch_mtx;
+    const Startup                       _startup;
+    const Placement                     _placement;
+    std::atomic_uint                    _size;
+    const size_t                        _stack_size;
+    std::atomic_uint                    _blocked = {0}; // workers in a blocking region
+    std::atomic<_nimata_impl::_worker*> _workers;
+    std::mutex                          _fronts_mtx;
+    std::vector<_nimata_impl::_front*>  _fronts;
+    size_t                              _cursor = 0;
+    std::thread                         _assignation_thread;
+  };
+//*///------------------------------------------------------------------------------------------------------------------
+  class Pool
+  {
+  public:
+    // constructs pool with its own workers
+    inline Pool(signed number_of_threads = max_threads, size_t stack_size = default_stack_size) noexcept;
+
+    // constructs pool with its own workers, deferring the spawning of threads as specified by 'startup'
+    inline Pool(Startup startup, signed number_of_threads = max_threads, size_t stack_size = default_stack_size) noexcept;
+
+    // constructs pool with its own workers, sized and placed following the cpu topology
+    inline Pool(Placement placement, Startup startup = eager, size_t stack_size = default_stack_size) noexcept;
+
+    // constructs pool running at most 'concurrency' tasks at once on the workers of 'arena'
+    inline Pool(Arena& arena, signed concurrency = max_threads) noexcept;
+
+    // add work and specify if you want it detached or not
+    template<Tracking tracking = Tracking::infer, typename Callable, typename... Arguments>
+    inline auto push
+    (
+      Callable&&     callable,
+      Arguments&&... arguments
+    ) noexcept -> _nimata_impl::_tracking<tracking, Callable, Arguments...>;
+
+    // push 'callable(arguments...)' once 'delay' elapsed, to the millisecond
+    template<typename Rep, typename Period, typename Callable, typename... Arguments>
+    auto push_after
+    (
+      std::chrono::duration<Rep, Period> delay,
+      Callable&&                         callable,
+      Arguments&&...                     arguments
+    ) noexcept -> Timer;
+
+    // push 'callable(arguments...)' once 'time' is reached, to the millisecond
+    template<typename Clock, typename Duration, typename Callable, typename... Arguments>
+    auto push_at
+    (
+      std::chrono::time_point<Clock, Duration> time,
+      Callable&&                               callable,
+      Arguments&&...                           arguments
+    ) noexcept -> Timer;
+
+    // strand of 'key', tasks pushed to it run in order and one at a time, keys whose hashes are equal share it
+    template<typename Key>
+    auto strand(const Key& key) noexcept -> Strand;
+
+    // push 'callable(arguments...)' to the strand of 'key'
+    template<typename Key, typename Callable, typename... Arguments>
+    void push_keyed(const Key& key, Callable&& callable, Arguments&&... arguments) noexcept;
+
+    // push 'callable(arguments...)' if the queue has room for it
+    template<typename Callable, typename... Arguments>
+    auto try_push(Callable&& callable, Arguments&&... arguments) noexcept -> bool;
+
+    // bound the queue to 'capacity' tasks, 0 is unbounded, 'overflow' tells what push does once it is full
+    inline void capacity(size_t capacity, Overflow overflow = block) noexcept;
+
+    // get the maximum amount of queued tasks, 0 is unbounded
+    inline auto capacity() const noexcept -> size_t;
+
+    // get the amount of queued tasks, those already handed to a worker excluded
+    inline auto depth() const noexcept -> size_t;
+
+    // waits for all work to be done, delayed tasks that are not due yet excluded
+    inline void wait() const noexcept;
+
+    // cancel delayed tasks, run every queued task and wait for the running ones
+    inline void drain() noexcept;
+
+    // cancel delayed tasks, discard queued tasks, those waiting in strands and batches lined up for workers, then
+    // wait for the running ones, get the amount discarded, discarded tasks that were bound or chained break their promise
+    inline auto abandon() noexcept -> size_t;
+
+    // drain for at most 'timeout' then abandon what is left, get whether nothing was discarded
+    template<typename Rep, typename Period>
+    auto shutdown_for(std::chrono::duration<Rep, Period> timeout) noexcept -> bool;
+
+    // enable workers
+    inline void work() noexcept;
+
+    // disable workers
+    inline void stop() noexcept;
+
+    // parallel for-loop with index range = [0, 'size')
+    inline auto parfor(size_t size) noexcept -> _nimata_impl::_parfor<size_t>;
+
+    // parallel for-loop with index range = ['from', 'past')
+    inline auto parfor(size_t from, size_t past) noexcept -> _nimata_impl::_parfor<size_t>;
+
+    // parallel for-loop over iterable
+    template<typename Iterable, typename = _nimata_impl::_if_iterable<Iterable>>
+    inline auto parfor(Iterable&& thing) noexcept -> _nimata_impl::_parfor<Iterable>;
+
+    // parallel for-loop over fixed-size array
+    template<typename Type, size_t Size>
+    auto parfor(Type (&array)[Size]) noexcept -> _nimata_impl::_parfor<Type*>;
+
+    // get amount of workers, or concurrency limit if the arena is shared
+    inline auto size() const noexcept -> unsigned;
+
+    // set amount of workers, or concurrency limit if the arena is shared
+    inline void size(signed number_of_threads) noexcept;
+
+    // get stack size of workers
+    inline auto stack_size() const noexcept -> size_t;
+
+# if defined(_stz_impl_FIBERS)
+    // run pushed tasks on fibers, which suspend instead of blocking their worker when they wait
+    inline void fibers(bool enabled) noexcept;
+
+    // whether pushed tasks run on fibers
+    inline auto fibers() const noexcept -> bool;
+# endif
+
+    // one lazily constructed 'Type' per worker
+    template<typename Type>
+    class local;
+
+# if defined(_stz_impl_COROUTINES)
+    // 'co_await pool.schedule()' resumes the awaiting coroutine on a worker
+    inline auto schedule() noexcept -> _nimata_impl::_schedule;
+# endif
+
+    // drains then join threads
+    inline ~Pool() noexcept;
+
+  private:
+    template<typename> friend struct _nimata_impl::_parfor;
+    template<typename> friend struct _nimata_impl::_push;
+    template<typename> friend class Future;
+    friend class TaskGraph;
+    friend class TaskGroup;
+    friend class Pipeline;
+    template<typename> friend class Channel;
+    friend class Reactor;
+    friend class _nimata_impl::_wheel;
+# if defined(_stz_impl_FIBERS)
+    friend class _nimata_impl::_fiber;
+# endif
+    friend class Strand;
+    friend class Producer;
+# if defined(_stz_impl_SHARED)
+    friend class SharedQueue;
+# endif
+# if defined(_stz_impl_COROUTINES)
+    friend struct _nimata_impl::_schedule;
+# endif
+    std::unique_ptr<Arena>              _owned;
+    Arena* const                        _arena;
+    _nimata_impl::_front                _front;
+    std::atomic_bool                    _timed = {false}; // whether delayed tasks were ever pushed
+    inline auto _delay(std::chrono::steady_clock::time_point time, _nimata_impl::_task&& task) noexcept -> Timer;
+    _nimata_impl::_strands              _keyed;
+    inline void _serialize(_nimata_impl::_strand* strand, _nimata_impl::_task&& task) noexcept;
+    inline void _drain(_nimata_impl::_strand* strand) noexcept;
+    inline void _enqueue(_nimata_impl::_task&& task) noexcept;
+    inline void _submit(_nimata_impl::_task&& task) noexcept;
+    inline void _admit(_nimata_impl::_task&& task) noexcept;
+    inline void _publish(std::vector<_nimata_impl::_task>& tasks) noexcept;
+
+    template<typename F, typename... A>
+    auto push(_nimata_impl::_detached, F&& function, A&&... arguments) noexcept -> void;
+    template<typename F, typename... A>
+    auto push(_nimata_impl::_attached, F&& function, A&&... arguments) noexcept -> _nimata_impl::_future<F, A...>;
+    template<typename F, typename... A>
+    auto push(_nimata_impl::_chaining, F&& function, A&&... arguments) noexcept -> Future<_nimata_impl::_result<F, A...>>;
+    template<typename F, typename... A>
+    auto push(_nimata_impl::_inferred, F&& function, A&&... arguments) noexcept -> _nimata_impl::_auto<F, A...>;
+  };
+//*///------------------------------------------------------------------------------------------------------------------
+  template<typename Type>
+  class Future final
+  {
+  public:
+    // constructs invalid future
+    Future() noexcept = default;
+
+    inline Future(Future&& other) noexcept;
+    inline auto operator=(Future&& other) noexcept -> Future&;
+
+    // whether the future refers to a result
+    inline bool valid() const noexcept;
+
+    // whether the result is available
+    inline bool ready() const noexcept;
+
+    // whether the task was discarded instead of setting the result
+    inline bool broken() const noexcept;
+
+    // waits for the result to be available, returns right away if the future is invalid
+    inline void wait() const noexcept;
+
+    // waits for the result then moves it out, the future is invalid afterward, throws 'std::future_error' with
+    // 'std::future_errc::no_state' if the future is invalid or 'std::future_errc::broken_promise' if the task was discarded
+    inline auto get() -> Type;
+
+    // push 'callable(result)' to 'pool' once the result is available, the future is invalid afterward,
+    // so is the returned one if this future is invalid
+    template<typename Callable>
+    inline auto then(Pool& pool, Callable&& callable) noexcept -> Future<typename _nimata_impl::_next<
+      typename std::decay<Callable>::type, _nimata_impl::_stored<Type>>::type>;
+
+    inline ~Future() noexcept;
+
+# if defined(_stz_impl_COROUTINES)
+    class _awaiter;
+
+    // 'co_await future' resumes the awaiting coroutine on the thread that sets the result
+    inline auto operator co_await() noexcept -> _awaiter;
+# endif
+
+  private:
+    template<typename> friend class Future;
+    friend class Pool;
+    friend class TaskGraph;
+    friend class Pipeline;
+    friend class Reactor;
+    friend struct _nimata_impl::_combine;
+    using _state = _nimata_impl::_state<_nimata_impl::_stored<Type>>;
+    inline Future(_state* state) noexcept;
+    _state* _shared = nullptr;
+  };
+//*///------------------------------------------------------------------------------------------------------------------
+  namespace _nimata_impl
+  {
+    template<typename Type>
+    struct _parfor final
+    {
+      using iterator = typename _iter_type<Type>::iter;
+
+      _parfor(Pool* const pool_, const iterator& from_, const iterator& past_) noexcept
+        : _pool(pool_)
+        , _from(from_)
+        , _past(past_)
+      {}
+
+      template<typename Callable>
+      void operator=(Callable&& callable_) noexcept
+      {
+        _pool->_arena->_launch();
+
+        {
+          std::lock_guard<std::mutex> pool_queue_lock(_pool->_front._queue_mtx);
+
+          for (iterator iter = std::move(_from); iter != _past; ++iter)
+          {
+            ++_pool->_front._pending;
+            _pool->_front._queue.push([=]{ callable_(_iter_type<Type>::_deref(iter)); });
+          }
+        }
+
+        _pool->wait();
+      }
+
+      Pool* const    _pool;
+      iterator       _from;
+      const iterator _past;
+    };
+
+    template<typename Result>
+    struct _infer;
+
+    template<>
+    struct _infer<void>
+    {
+      template<typename Callable, typename... Arguments>
+      static
+      void _impl(Pool* const pool_, Callable&& callable_, Arguments&&... arguments_)
+      {
+        return pool_->push<Tracking::stray>(std::forward<Callable>(callable_), std::forward<Arguments>(arguments_)...);
+      }
+    };
+
+    template<typename Result>
+    struct _infer
+    {
+      template<typename Callable, typename... Arguments>
+      static
+      auto _impl(Pool* const pool_, Callable&& callable_, Arguments&&... arguments_) -> std::future<Result>
+      {
+        return pool_->push<Tracking::bound>(std::forward<Callable>(callable_), std::forward<Arguments>(arguments_)...);
+      }
+    };
+
+    template<>
+    struct _push<void>
+    {
+      template<typename Callable, typename... Arguments>
+      static
+      auto _impl(Pool* const pool_, Callable&& callable_, Arguments&&... arguments_) -> std::future<void>
+      {
+        std::future<void> future;
+
+        if _stz_impl_EXPECTED(_nimata_impl::_validate_callable(callable_) == true)
+        {
+          std::promise<void> promise;
+          future = promise.get_future();
+
+          pool_->_submit(_promised<void, _binding<Callable, Arguments...>>{
+            std::move(promise), _bind(std::forward<Callable>(callable_), std::forward<Arguments>(arguments_)...)
+          });
+
+          _stz_impl_DBG_LVL_2(_stz_impl_DEBUG_MESSAGE("pushed an attached task.");)
+        }
+        else
+        {
+          _stz_impl_DBG_LVL_2(_stz_impl_DEBUG_MESSAGE("null task pushed.");)
+        }
+
+        return future;
+      }
+    };
+
+    template<typename ResultType>
+    struct _push
+    {
+      template<typename Callable, typename... Arguments>
+      static
+      auto _impl(Pool* const pool_, Callable&& callable_, Arguments&&... arguments_) -> std::future<ResultType>
+      {
+        std::future<ResultType> future;
+
+        if _stz_impl_EXPECTED(_nimata_impl::_validate_callable(callable_) == true)
+        {
+          std::promise<ResultType> promise;
+          future = promise.get_future();
+
+          pool_->_submit(_promised<ResultType, _binding<Callable, Arguments...>>{
+            std::move(promise), _bind(std::forward<Callable>(callable_), std::forward<Arguments>(arguments_)...)
+          });
+
+          _stz_impl_DBG_LVL_2(_stz_impl_DEBUG_MESSAGE("pushed a task with return value.");)
+        } 
+        else
+        {
+          _stz_impl_DBG_LVL_2(_stz_impl_DEBUG_MESSAGE("null task pushed.");)
+        }
+
+        return future;
+      }
+    };
+  }
+//*///------------------------------------------------------------------------------------------------------------------
+  Arena::Arena(const signed N_, const size_t stack_size_) noexcept
+    : Arena(Startup::eager, Placement::floating, N_, stack_size_)
+  {}
+
+  Arena::Arena(const Startup startup_, const signed N_, const size_t stack_size_) noexcept
+    : Arena(startup_, Placement::floating, N_, stack_size_)
+  {}
+
+  Arena::Arena(const Placement placement_, const Startup startup_, const size_t stack_size_) noexcept
+    : Arena(startup_, placement_, placement_ == Placement::physical_cores
+      ? static_cast<signed>(_nimata_impl::_process_topology()._cores.size()) : max_threads, stack_size_)
+  {}
+
+  Arena::Arena(const Startup startup_, const Placement placement_, const signed N_, const size_t stack_size_) noexcept
+    : _startup(startup_)
+    , _placement(placement_)
+    , _size(_nimata_impl::_compute_number_of_threads(N_))
+    , _stack_size(stack_size_)
+    , _workers(_nimata_impl::_recruit(_size, this, &_blocked, _placement))
+  {
+    if (_startup == Startup::eager)
+    {
+      _launch();
+    }
+
+    _stz_impl_DBG_LVL_0(_stz_impl_DEBUG_MESSAGE("%u thread%s aquired.", _size.load(), _size == 1 ? "" : "s");)
+  }
+
+  auto Arena::size() const noexcept -> unsigned
+  {
+    return _size;
+  }
+
+  auto Arena::stack_size() const noexcept -> size_t
+  {
+    return _stack_size;
+  }
+
+  void Arena::size(const signed N_) noexcept
+  {
+    _alive = false;
+    if (_launched)
+    {
+      _assignation_thread.join();
+    }
+
+    for (unsigned k = 0; k < _capacity(); ++k)
+    {
+      while (_workers[k]._busy())
+      {
+        std::this_thread::sleep_for(std::chrono::nanoseconds(1));
+      }
+    }
+
+    _size = _nimata_impl::_compute_number_of_threads(N_);
+
+    delete[] _workers;
+    _workers = _nimata_impl::_recruit(_size, this, &_blocked, _placement);
+
+    _alive = true;
+    if (_launched)
+    {
+      _assignation_thread = std::thread(&Arena::_assign, this);
+    }
+  }
+
+  Arena::~Arena() noexcept
+  {
+    _alive = false;
+    if (_launched)
+    {
+      _assignation_thread.join();
+    }
+
+    delete[] _workers;
+
+    _stz_impl_DBG_LVL_0(_stz_impl_DEBUG_MESSAGE("all workers killed.");)
+  }
+
+  void Arena::_attach(_nimata_impl::_front* const front_) noexcept
+  {
+    std::lock_guard<std::mutex>{_fronts_mtx}, _fronts.push_back(front_);
+  }
+
+  void Arena::_detach(_nimata_impl::_front* const front_) noexcept
+  {
+    std::lock_guard<std::mutex> lock{_fronts_mtx};
+    _fronts.erase(std::find(_fronts.begin(), _fronts.end(), front_));
+  }
+
+  void Arena::_launch() noexcept
+  {
+    if _stz_impl_EXPECTED(_launched)
+    {
+      return;
+    }
+
+    std::lock_guard<std::mutex> lock{_launch_mtx};
+    if (_launched == false)
+    {
+      _assignation_thread = std::thread(&Arena::_assign, this);
+      _launched = true;
+
+      _stz_impl_DBG_LVL_1(_stz_impl_DEBUG_MESSAGE("assignation thread launched.");)
+    }
+  }
+
+  void Arena::_assign() noexcept
+  {
+    // spawning workers here keeps the construction of arenas cheap for the calling thread
+    unsigned spawned = 0;
+    if (_startup != Startup::gradual)
+    {
+      for (; spawned < _size; ++spawned)
+      {
+        _workers[spawned]._start(_stack_size);
+      }
+    }
+
+    while _stz_impl_EXPECTED(_alive)
+    {
+      {
+        std::lock_guard<std::mutex> fronts_lock{_fronts_mtx};
+
+        // round-robin between pools so that none of them starves the others
+        bool saturated = false;
+        for (bool progress = true; progress and not saturated;)
+        {
+          progress = false;
+
+          for (size_t n = _fronts.size(); n and not saturated; --n)
+          {
+            _nimata_impl::_front* const front = _fronts[_cursor++ % _fronts.size()];
+
+            if (front->_active == false)
+            {
+              continue;
+            }
+
+            std::lock_guard<std::mutex> lock{front->_queue_mtx};
+            if (front->_queue.empty())
+            {
+              continue;
+            }
+
+            // keep a pool's work on workers sharing caches with the one that ran its previous task
+            const bool below_limit = front->_running < front->_limit;
+            signed k = below_limit ? _nearest_idle(front->_last) : -1;
+
+            // workers in a blocking region don't count against the limit, spares run work in their stead
+            if (k < 0 and below_limit and _blocked != 0)
+            {
+              k = _spare();
+            }
+
+            // line up the next batch of short tasks behind a running one when there is work for every worker anyway,
+            // this occupies no additional worker, but work lined up behind a long or blocking task would wait for it
+            if (k < 0 and front->_queue.size() >= _size and front->_cost < _span and _blocked == 0)
+            {
+              k = _nearest_follower(*front);
+            }
+
+            if (k < 0)
+            {
+              if (below_limit)
+              {
+                saturated = true;
+                break;
+              }
+
+              continue;
+            }
+
+            ++front->_running;
+            front->_last = static_cast<unsigned>(k);
+            _workers[k]._give(front->_queue, _batch_size(*front), front);
+            progress = true;
+
+            _stz_impl_DBG_LVL_2(_stz_impl_DEBUG_MESSAGE("assigned to worker thread #%02d.", k);)
+          }
+        }
+
+        // ramp up one worker at a time, only while every spawned worker is busy and work is waiting
+        if (saturated and spawned < _size)
+        {
+          _workers[spawned++]._start(_stack_size);
+
+          _stz_impl_DBG_LVL_1(_stz_impl_DEBUG_MESSAGE("worker thread #%02u spawned.", spawned - 1);)
+        }
+      }
+
+      _retire_spares();
+
+      std::this_thread::yield();
+    }
+  }
+
+  // enough tasks to keep a worker busy for about 50 microseconds, without taking more than its share of the queue,
+  // tiny tasks are only grouped once the queue is deep enough to feed every worker the pool may use
+  auto Arena::_batch_size(const _nimata_impl::_front& front_) const noexcept -> unsigned
+  {
+    const unsigned cost   = std::max(front_._cost.load(std::memory_order_relaxed), 1u);
+    const size_t   wanted = std::max<size_t>(_span / cost, 1);
+    const size_t   share  = std::max<size_t>(front_._queue.size() / std::min<unsigned>(_size, front_._limit), 1);
+
+    return static_cast<unsigned>(std::min(std::min(wanted, share), size_t(_nimata_impl::_slot::_capacity)));
+  }
+
+  auto Arena::_nearest_idle(const unsigned worker_) const noexcept -> signed
+  {
+    for (const unsigned k : _workers[worker_ % _size]._neighbours)
+    {
+      if (_workers[k]._idle())
+      {
+        return static_cast<signed>(k);
+      }
+    }
+
+    return -1;
+  }
+
+  auto Arena::_nearest_follower(const _nimata_impl::_front& front_) const noexcept -> signed
+  {
+    for (const unsigned k : _workers[front_._last % _size]._neighbours)
+    {
+      if (_workers[k]._follows(&front_))
+      {
+        return static_cast<signed>(k);
+      }
+    }
+
+    return -1;
+  }
+
+  // idle spare, spawned on demand, while there are fewer spares in use than workers in a blocking region
+  auto Arena::_spare() noexcept -> signed
+  {
+    const unsigned wanted = std::min<unsigned>(_blocked, _size);
+
+    for (unsigned k = _size; k < _size + wanted; ++k)
+    {
+      if (_workers[k]._spawned() == false)
+      {
+        _workers[k]._start(_stack_size);
+
+        _stz_impl_DBG_LVL_1(_stz_impl_DEBUG_MESSAGE("spare thread #%02u spawned.", k);)
+
+        return static_cast<signed>(k);
+      }
+
+      if (_workers[k]._idle())
+      {
+        return static_cast<signed>(k);
+      }
+    }
+
+    return -1;
+  }
+
+  // spares beyond the amount of workers in a blocking region exit once they are done with their work
+  void Arena::_retire_spares() noexcept
+  {
+    for (unsigned k = _size + std::min<unsigned>(_blocked, _size); k < _capacity(); ++k)
+    {
+      if (_workers[k]._idle())
+      {
+        _workers[k]._retire();
+
+        _stz_impl_DBG_LVL_1(_stz_impl_DEBUG_MESSAGE("spare thread #%02u retired.", k);)
+      }
+    }
+  }
+
+  // workers and spares
+  auto Arena::_capacity() const noexcept -> unsigned
+  {
+    return 2 * _size;
+  }
+
+  auto arena() noexcept -> Arena&
+  {
+    static Arena process_wide(Startup::lazy);
+    return process_wide;
+  }
+
+  auto this_worker::index() noexcept -> signed
+  {
+    return _nimata_impl::_this_worker()._index;
+  }
+//*///------------------------------------------------------------------------------------------------------------------
+  class blocking_region final
+  {
+  public:
+    // the calling worker is about to block, its pool may run a spare worker in its stead, no-op for other threads
+    inline blocking_region() noexcept;
+
+    blocking_region(const blocking_region&) = delete;
+    auto operator=(const blocking_region&) -> blocking_region& = delete;
+
+    // the worker is done blocking, the spare retires once its work is done
+    inline ~blocking_region() noexcept;
+  };
+
+  // nested regions only count once
+  blocking_region::blocking_region() noexcept
+  {
+    _nimata_impl::_identity& worker = _nimata_impl::_this_worker();
+
+    if (worker._blocked != nullptr and worker._depth++ == 0)
+    {
+      --worker._origin->_running;
+      ++*worker._blocked;
+    }
+  }
+
+  blocking_region::~blocking_region() noexcept
+  {
+    _nimata_impl::_identity& worker = _nimata_impl::_this_worker();
+
+    if (worker._blocked != nullptr and --worker._depth == 0)
+    {
+      ++worker._origin->_running;
+      --*worker._blocked;
+    }
+  }
+//*///------------------------------------------------------------------------------------------------------------------
+  Pool::Pool(const signed N_, const size_t stack_size_) noexcept
+    : Pool(Startup::eager, N_, stack_size_)
+  {}
+
+  Pool::Pool(const Startup startup_, const signed N_, const size_t stack_size_) noexcept
+    : _owned(new Arena(startup_, N_, stack_size_))
+    , _arena(_owned.get())
+  {
+    _front._limit = _arena->size();
+    _arena->_attach(&_front);
+  }
+
+  Pool::Pool(const Placement placement_, const Startup startup_, const size_t stack_size_) noexcept
+    : _owned(new Arena(placement_, startup_, stack_size_))
+    , _arena(_owned.get())
+  {
+    _front._limit = _arena->size();
+    _arena->_attach(&_front);
+  }
+
+  Pool::Pool(Arena& arena_, const signed N_) noexcept
+    : _arena(&arena_)
+  {
+    _front._limit = _nimata_impl::_compute_number_of_threads(N_);
+    _arena->_attach(&_front);
+  }
+
+  template<Tracking T, typename Callable, typename... Arguments>
+  auto Pool::push
+  (
+    Callable&&     callable_,
+    Arguments&&... arguments_
+  ) noexcept -> _nimata_impl::_tracking<T, Callable, Arguments...>
+  {
+    return push(std::integral_constant<Tracking, T>(), std::forward<Callable>(callable_), std::forward<Arguments>(arguments_)...);
+  }
+  
+  template<typename Callable, typename... Arguments>
+  auto Pool::push(_nimata_impl::_detached, Callable&& callable_, Arguments&&... arguments_) noexcept -> void
+  {
+    if _stz_impl_EXPECTED(_nimata_impl::_validate_callable(callable_) == true)
+    {
+      _submit(_nimata_impl::_bind(std::forward<Callable>(callable_), std::forward<Arguments>(arguments_)...));
+
+      _stz_impl_DBG_LVL_2(_stz_impl_DEBUG_MESSAGE("pushed a task with no return value.");)
+    }
+    else
+    {
+      _stz_impl_DBG_LVL_2(_stz_impl_DEBUG_MESSAGE("null task pushed.");)
+    }
+
+    return;
+  }
+
+  template<typename Callable, typename... Arguments>
+  _stz_impl_NODISCARD_REASON("stz: push: wrap in a lambda if you don't use the return value.")
+  auto Pool::push
+  (
+    _nimata_impl::_attached,
+    Callable&&     callable_,
+    Arguments&&... arguments_
+  ) noexcept -> _nimata_impl::_future<Callable, Arguments...>
+  {
+    return _nimata_impl::_push<_nimata_impl::_result<Callable, Arguments...>>::_impl(this,
+      std::forward<Callable>(callable_), std::forward<Arguments>(arguments_)...);
+  }
+
+  template<typename Callable, typename... Arguments>
+  _stz_impl_NODISCARD_REASON("stz: push: wrap in a lambda if you don't use the return value.")
+  auto Pool::push
+  (
+    _nimata_impl::_chaining,
+    Callable&&     callable_,
+    Arguments&&... arguments_
+  ) noexcept -> Future<_nimata_impl::_result<Callable, Arguments...>>
+  {
+    using Result = _nimata_impl::_result<Callable, Arguments...>;
+    using State  = _nimata_impl::_state<_nimata_impl::_stored<Result>>;
+
+    if _stz_impl_ABNORMAL(_nimata_impl::_validate_callable(callable_) == false)
+    {
+      _stz_impl_DBG_LVL_2(_stz_impl_DEBUG_MESSAGE("null task pushed.");)
+      return Future<Result>();
+    }
+
+    State* const state = new State;
+
+    _submit(_nimata_impl::_chained<Result, _nimata_impl::_binding<Callable, Arguments...>>{
+      state, _nimata_impl::_bind(std::forward<Callable>(callable_), std::forward<Arguments>(arguments_)...)
+    });
+
+    _stz_impl_DBG_LVL_2(_stz_impl_DEBUG_MESSAGE("pushed a chained task.");)
+
+    return Future<Result>(state);
+  }
+
+  template<typename Callable, typename... Arguments>
+  auto Pool::push
+  (
+    _nimata_impl::_inferred,
+    Callable&&     callable_,
+    Arguments&&... arguments
+  ) noexcept -> _nimata_impl::_auto<Callable, Arguments...>
+  {
+    return _nimata_impl::_infer<_nimata_impl::_result<Callable, Arguments...>>::_impl(this,
+      std::forward<Callable>(callable_), std::forward<Arguments>(arguments)...);
+  }
+
+  namespace _nimata_impl
+  {
+#   if defined(_stz_impl_FIBERS)
+    // user-mode thread running a task of a pool, any worker of the pool may resume it once it is suspended
+    class _fiber final
+    {
+    public:
+      // run 'work' on a fiber, the calling thread carries on once it is done or suspended
+      static inline void _launch(Pool* pool, _task&& work) noexcept;
+
+      // suspend the calling fiber, 'arm' runs once the fiber is switched out and must lead to '_wake'
+      static inline void _suspend(_task&& arm) noexcept;
+
+      // suspend the calling fiber and requeue it right away so other work runs meanwhile
+      static inline void _yield() noexcept;
+
+      // queue the resumption of a suspended fiber onto its pool
+      static inline void _wake(_fiber* fiber) noexcept;
+
+      // fiber running on the calling thread, if any
+      static inline auto _current() noexcept -> _fiber*&;
+
+      // whether the calling thread runs a fiber that may be suspended
+      static inline auto _suspendable() noexcept -> bool;
+
+      inline ~_fiber() noexcept;
+
+    private:
+      struct _waker final
+      {
+        void operator()() const noexcept { _wake(_fiber_); }
+        _fiber* const _fiber_;
+      };
+
+      struct _resumer final
+      {
+        void operator()() const noexcept { _enter(_fiber_); }
+        _fiber* const _fiber_;
+      };
+
+      static inline auto _acquire() noexcept -> _fiber*;
+      static inline void _recycle(_fiber* fiber) noexcept;
+      static inline void _enter(_fiber* fiber) noexcept;
+      static inline void _main() noexcept;
+
+      // kept apart as getcontext returns twice, which would clobber the caller's variables
+      static bool _capture(ucontext_t* const context_) noexcept
+      {
+        return getcontext(context_) == 0;
+      }
+      ucontext_t  _context;
+      ucontext_t* _return   = nullptr; // context of the thread that switched to the fiber
+      void*       _stack    = nullptr;
+      size_t      _mapped   = 0;
+      Pool*       _pool     = nullptr;
+      _task       _work;
+      _task       _arm;
+      bool        _finished = false;
+    };
+
+    // fibers are kept per thread to be reused along with their stack
+    inline
+    auto _fibers() noexcept -> std::vector<std::unique_ptr<_fiber>>&
+    {
+      static thread_local std::vector<std::unique_ptr<_fiber>> cache;
+      return cache;
+    }
+
+    void _fiber::_launch(Pool* const pool_, _task&& work_) noexcept
+    {
+      _fiber* const fiber = _acquire();
+      if _stz_impl_ABNORMAL(fiber == nullptr)
+      {
+        _stz_impl_DBG_LVL_0(_stz_impl_DEBUG_MESSAGE("fiber could not be created, task runs on its worker.");)
+        work_();
+        return;
+      }
+
+      fiber->_pool = pool_;
+      fiber->_work = std::move(work_);
+      _enter(fiber);
+    }
+
+    void _fiber::_suspend(_task&& arm_) noexcept
+    {
+      _fiber* const self = _current();
+      self->_arm = std::move(arm_);
+      swapcontext(&self->_context, self->_return);
+    }
+
+    void _fiber::_yield() noexcept
+    {
+      _suspend(_waker{_current()});
+    }
+
+    // the fiber stays pending for its pool until it is done, even while suspended
+    void _fiber::_wake(_fiber* const fiber_) noexcept
+    {
+      Pool* const pool = fiber_->_pool;
+      pool->_enqueue(_resumer{fiber_});
+      --pool->_front._pending;
+    }
+
+    auto _fiber::_current() noexcept -> _fiber*&
+    {
+      static thread_local _fiber* current = nullptr;
+      return current;
+    }
+
+    // a fiber inside a blocking region keeps its worker, which is accounted as blocked, until the region ends
+    auto _fiber::_suspendable() noexcept -> bool
+    {
+      return _current() != nullptr and _this_worker()._depth == 0;
+    }
+
+    _fiber::~_fiber() noexcept
+    {
+      munmap(_stack, _mapped);
+    }
+
+    // stacks are mapped with a guard page below them
+    auto _fiber::_acquire() noexcept -> _fiber*
+    {
+      std::vector<std::unique_ptr<_fiber>>& cache = _fibers();
+      if (not cache.empty())
+      {
+        _fiber* const fiber = cache.back().release();
+        cache.pop_back();
+        return fiber;
+      }
+
+      const size_t page   = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+      const size_t usable = (fiber_stack_size + page - 1) / page * page;
+
+      void* const stack = mmap(nullptr, usable + page, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK, -1, 0);
+      if (stack == MAP_FAILED)
+      {
+        return nullptr;
+      }
+
+      mprotect(stack, page, PROT_NONE);
+
+      std::unique_ptr<_fiber> fiber(new _fiber);
+      fiber->_stack  = stack;
+      fiber->_mapped = usable + page;
+
+      if (_capture(&fiber->_context) == false)
+      {
+        return nullptr;
+      }
+
+      fiber->_context.uc_stack.ss_sp   = static_cast<char*>(stack) + page;
+      fiber->_context.uc_stack.ss_size = usable;
+      fiber->_context.uc_link          = nullptr;
+      makecontext(&fiber->_context, &_fiber::_main, 0);
+
+      return fiber.release();
+    }
+
+    void _fiber::_recycle(_fiber* const fiber_) noexcept
+    {
+      std::vector<std::unique_ptr<_fiber>>& cache = _fibers();
+      if (cache.size() < 64)
+      {
+        cache.emplace_back(fiber_);
+      }
+      else
+      {
+        delete fiber_;
+      }
+    }
+
+    // switch to 'fiber' until it is done or suspended, in which case it is armed once switched out
+    void _fiber::_enter(_fiber* const fiber_) noexcept
+    {
+      _fiber* const outer = _current();
+
+      ucontext_t here;
+      fiber_->_return = &here;
+      _current() = fiber_;
+      swapcontext(&here, &fiber_->_context);
+      _current() = outer;
+
+      if (fiber_->_finished)
+      {
+        fiber_->_finished = false;
+        _recycle(fiber_);
+        return;
+      }
+
+      // once armed the fiber may be resumed by another worker, it must not be touched afterwards
+      ++fiber_->_pool->_front._pending;
+      _task arm = std::move(fiber_->_arm);
+      arm();
+    }
+
+    // a fiber runs tasks until it is destroyed, its context is only made once
+    void _fiber::_main() noexcept
+    {
+      _fiber* const self = _current();
+
+      while (true)
+      {
+        self->_work();
+        self->_work     = nullptr;
+        self->_finished = true;
+        swapcontext(&self->_context, self->_return);
+      }
+    }
+
+    struct _fibered final
+    {
+      void operator()() noexcept
+      {
+        _fiber::_launch(_pool, std::move(_work));
+      }
+      Pool* const _pool;
+      _task       _work;
+    };
+
+    template<>
+    struct _user_work<_fibered> : std::true_type {};
+#   endif
+
+    // let other work run while waiting, a fiber is suspended and requeued, a thread sleeps
+    inline
+    void _pause() noexcept
+    {
+#   if defined(_stz_impl_FIBERS)
+      if (_fiber::_suspendable())
+      {
+        _fiber::_yield();
+        return;
+      }
+#   endif
+
+      std::this_thread::sleep_for(std::chrono::nanoseconds(1));
+    }
+  }
+
+  void Pool::_enqueue(_nimata_impl::_task&& task_) noexcept
+  {
+    _arena->_launch();
+    _front._push(std::move(task_));
+  }
+
+  // only work pushed by users is subject to the capacity, internal work such as continuations never waits
+  void Pool::_submit(_nimata_impl::_task&& task_) noexcept
+  {
+# if defined(_stz_impl_FIBERS)
+    if (_front._fibered.load(std::memory_order_relaxed))
+    {
+      task_ = _nimata_impl::_fibered{this, std::move(task_)};
+    }
+# endif
+
+    _nimata_impl::_buffer* const buffer = _nimata_impl::_collector();
+    if (buffer != nullptr and buffer->_pool == this)
+    {
+      buffer->_tasks.push_back(std::move(task_));
+      if (buffer->_tasks.size() >= buffer->_capacity)
+      {
+        _publish(buffer->_tasks);
+      }
+      return;
+    }
+
+    _admit(std::move(task_));
+  }
+
+  // push 'task', already wrapped for its pool, while honouring the capacity
+  void Pool::_admit(_nimata_impl::_task&& task_) noexcept
+  {
+    const size_t capacity = _front._capacity.load(std::memory_order_relaxed);
+
+    if _stz_impl_EXPECTED(capacity == 0)
+    {
+      return _enqueue(std::move(task_));
+    }
+
+    _arena->_launch();
+
+    switch (_front._overflow.load(std::memory_order_relaxed))
+    {
+      case Overflow::drop_oldest:
+        _front._push_dropping(std::move(task_), capacity);
+        return;
+
+      case Overflow::caller_runs:
+        if (_front._try_push(task_, capacity) == false)
+        {
+          task_();
+        }
+        return;
+
+      case Overflow::block:
+      default:
+        while (_front._try_push(task_, capacity) == false)
+        {
+          // a worker waiting on its own pool could wait forever
+          if (_nimata_impl::_this_worker()._arena == _arena)
+          {
+            task_();
+            return;
+          }
+
+          std::this_thread::sleep_for(std::chrono::nanoseconds(1));
+        }
+    }
+  }
+
+  // publish 'tasks' at once, a bounded queue takes them one at a time to apply its overflow policy
+  void Pool::_publish(std::vector<_nimata_impl::_task>& tasks_) noexcept
+  {
+    if (tasks_.empty())
+    {
+      return;
+    }
+
+    if (_front._capacity.load(std::memory_order_relaxed) == 0)
+    {
+      _arena->_launch();
+      _front._push(tasks_);
+    }
+    else
+    {
+      // buffered tasks went through '_submit' already
+      for (_nimata_impl::_task& task : tasks_)
+      {
+        _admit(std::move(task));
+      }
+    }
+
+    tasks_.clear();
+  }
+
+  template<typename Callable, typename... Arguments>
+  auto Pool::try_push(Callable&& callable_, Arguments&&... arguments_) noexcept -> bool
+  {
+    if _stz_impl_ABNORMAL(_nimata_impl::_validate_callable(callable_) == false)
+    {
+      _stz_impl_DBG_LVL_2(_stz_impl_DEBUG_MESSAGE("null task pushed.");)
+      return false;
+    }
+
+    _nimata_impl::_task task = _nimata_impl::_bind(std::forward<Callable>(callable_), std::forward<Arguments>(arguments_)...);
+
+    const size_t capacity = _front._capacity.load(std::memory_order_relaxed);
+    if (capacity == 0)
+    {
+      _enqueue(std::move(task));
+      return true;
+    }
+
+    _arena->_launch();
+
+    return _front._try_push(task, capacity);
+  }
+
+  void Pool::capacity(const size_t capacity_, const Overflow overflow_) noexcept
+  {
+    _front._overflow = overflow_;
+    _front._capacity = capacity_;
+  }
+
+  auto Pool::capacity() const noexcept -> size_t
+  {
+    return _front._capacity;
+  }
+
+  auto Pool::depth() const noexcept -> size_t
+  {
+    // '_pending' also counts the tasks of batches lined up behind a running one, only the queue is left to hand out
+    std::lock_guard<std::mutex> lock{_front._queue_mtx};
+    return _front._queue.size();
+  }
+
+  void Pool::wait() const noexcept
+  {
+    if (_front._active == true)
+    {
+      while (_front._pending != 0)
+      {
+        std::this_thread::sleep_for(std::chrono::nanoseconds(1));
+      }
+
+      _stz_impl_DBG_LVL_1(_stz_impl_DEBUG_MESSAGE("all threads finished their work.");)
+    }
+  }
+
+  void Pool::work() noexcept
+  {
+    _front._active = true;
+  }
+
+  void Pool::stop() noexcept
+  {
+    _front._active = false;
+  }
+
+  void Pool::size(const signed N_) noexcept
+  {
+    if (_owned)
+    {
+      wait();
+
+      _arena->size(N_);
+      _front._limit = _arena->size();
+    }
+    else
+    {
+      _front._limit = _nimata_impl::_compute_number_of_threads(N_);
+    }
+  }
+
+  auto Pool::size() const noexcept -> unsigned
+  {
+    return _front._limit;
+  }
+
+  auto Pool::stack_size() const noexcept -> size_t
+  {
+    return _arena->stack_size();
+  }
+
+# if defined(_stz_impl_FIBERS)
+  void Pool::fibers(const bool enabled_) noexcept
+  {
+    _front._fibered = enabled_;
+  }
+
+  auto Pool::fibers() const noexcept -> bool
+  {
+    return _front._fibered;
+  }
+# endif
+
+  auto Pool::parfor(const size_t from_, const size_t past_) noexcept -> _nimata_impl::_parfor<size_t>
+  {
+    return _nimata_impl::_parfor<size_t>(this, from_, past_);
+  }
+
+  auto Pool::parfor(const size_t size_) noexcept -> _nimata_impl::_parfor<size_t>
+  {
+    return _nimata_impl::_parfor<size_t>(this, 0, size_);
+  }
+
+  template<typename iterable, typename>
+  auto Pool::parfor(iterable&& thing_) noexcept -> _nimata_impl::_parfor<iterable>
+  {
+    return _nimata_impl::_parfor<iterable>(this, _nimata_impl::_begin(thing_), _nimata_impl::_end(thing_));
+  }
+
+  template<typename Type, size_t Size>
+  auto Pool::parfor(Type (&array_)[Size]) noexcept -> _nimata_impl::_parfor<Type*>
+  {
+    return _nimata_impl::_parfor<Type*>(this, array_, array_ + Size);
+  }
+
+# define parfor(PARFOR_VARIABLE_DECLARATION, ...) parfor(__VA_ARGS__) = [&](PARFOR_VARIABLE_DECLARATION) -> void
+//*///------------------------------------------------------------------------------------------------------------------
+  namespace _nimata_impl
+  {
+    struct _link
+    {
+      _link* _prev = this;
+      _link* _next = this;
+    };
+
+    struct _timer final : public _link
+    {
+      uint64_t         _due = 0; // tick
+      Pool*            _pool;
+      _task            _work;
+      std::atomic_uint _references = {2}; // wheel and handle
+
+      void _release() noexcept
+      {
+        if (--_references == 0)
+        {
+          delete this;
+        }
+      }
+    };
+
+    // hierarchical timing wheel of millisecond ticks, each level is 256 times coarser than the previous one
+    class _wheel final
+    {
+    public:
+      static
+      auto _instance() noexcept -> _wheel&
+      {
+        // never destroyed so that pools destroyed at exit can still forget their timers
+        static _wheel* const process_wide = new _wheel;
+        return *process_wide;
+      }
+
+      void _insert(_timer* const timer_, const std::chrono::steady_clock::time_point time_) noexcept
+      {
+        std::lock_guard<std::mutex> lock(_mtx);
+
+        if (_count == 0)
+        {
+          _now = _tick(std::chrono::steady_clock::now());
+        }
+
+        const auto since = std::chrono::duration_cast<std::chrono::milliseconds>(time_ - _start).count();
+        timer_->_due = static_cast<uint64_t>(since < 0 ? 0 : since);
+
+        if (timer_->_due <= _now)
+        {
+          _fire(timer_);
+          return;
+        }
+
+        _place(timer_);
+        ++_count;
+
+        if (timer_->_due < _wake)
+        {
+          _cv.notify_one();
+        }
+      }
+
+      bool _cancel(_timer* const timer_) noexcept
+      {
+        std::lock_guard<std::mutex> lock(_mtx);
+
+        if (timer_->_next == timer_)
+        {
+          return false;
+        }
+
+        _unlink(timer_);
+        --_count;
+        timer_->_release();
+
+        return true;
+      }
+
+      // drop the timers of 'pool', which is being destroyed
+      void _forget(const Pool* const pool_) noexcept
+      {
+        std::lock_guard<std::mutex> lock(_mtx);
+
+        for (_link (&level)[_slots] : _heads)
+        {
+          for (_link& head : level)
+          {
+            for (_link* link = head._next; link != &head;)
+            {
+              _timer* const timer = static_cast<_timer*>(link);
+              link = link->_next;
+
+              if (timer->_pool == pool_)
+              {
+                _unlink(timer);
+                --_count;
+                timer->_release();
+              }
+            }
+          }
+        }
+      }
+
+    private:
+      static constexpr unsigned _levels = 4;
+      static constexpr unsigned _bits   = 8;
+      static constexpr unsigned _slots  = 1u << _bits;
+      static constexpr uint64_t _mask   = _slots - 1;
+
+      _wheel() noexcept :
+        _start(std::chrono::steady_clock::now())
+      {
+        std::thread(&_wheel::_loop, this).detach();
+      }
+
+      auto _tick(const std::chrono::steady_clock::time_point time_) const noexcept -> uint64_t
+      {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(time_ - _start).count());
+      }
+
+      static
+      void _unlink(_link* const link_) noexcept
+      {
+        link_->_prev->_next = link_->_next;
+        link_->_next->_prev = link_->_prev;
+        link_->_prev = link_->_next = link_;
+      }
+
+      // the level is the coarsest one the delay needs, delays beyond the last level are placed again once cascaded
+      void _place(_timer* const timer_) noexcept
+      {
+        const uint64_t horizon = (uint64_t(1) << (_bits * _levels)) - 1;
+        const uint64_t due     = timer_->_due - _now > horizon ? _now + horizon : timer_->_due;
+        const uint64_t delta   = due - _now;
+
+        unsigned level = 0;
+        while ((level + 1 < _levels) and (delta >> (_bits * (level + 1)) != 0))
+        {
+          ++level;
+        }
+
+        _link& head = _heads[level][(due >> (_bits * level)) & _mask];
+        timer_->_prev       = head._prev;
+        timer_->_next       = &head;
+        head._prev->_next   = timer_;
+        head._prev          = timer_;
+      }
+
+      void _fire(_timer* const timer_) noexcept
+      {
+        timer_->_pool->_enqueue(std::move(timer_->_work));
+        timer_->_release();
+      }
+
+      // move to the next tick, cascading coarser levels down before firing the finest one
+      void _advance() noexcept
+      {
+        ++_now;
+
+        // level 'top' cascades when the ticks of every finer level wrapped around
+        unsigned top = 0;
+        while ((top + 1 < _levels) and ((_now & ((uint64_t(1) << (_bits * (top + 1))) - 1)) == 0))
+        {
+          ++top;
+        }
+
+        for (unsigned level = top; level != 0; --level)
+        {
+          _link& head = _heads[level][(_now >> (_bits * level)) & _mask];
+
+          while (head._next != &head)
+          {
+            _timer* const timer = static_cast<_timer*>(head._next);
+            _unlink(timer);
+            _place(timer);
+          }
+        }
+
+        _link& head = _heads[0][_now & _mask];
+        while (head._next != &head)
+        {
+          _timer* const timer = static_cast<_timer*>(head._next);
+          _unlink(timer);
+          --_count;
+          _fire(timer);
+        }
+      }
+
+      // tick of the next timer of the finest level, or of the next cascade
+      auto _next_event() const noexcept -> uint64_t
+      {
+        uint64_t tick = _now + 1;
+        while ((tick & _mask) != 0)
+        {
+          const _link& head = _heads[0][tick & _mask];
+          if (head._next != &head)
+          {
+            break;
+          }
+
+          ++tick;
+        }
+
+        return tick;
+      }
+
+      void _loop() noexcept
+      {
+        std::unique_lock<std::mutex> lock(_mtx);
+
+        while (true)
+        {
+          if (_count == 0)
+          {
+            _wake = UINT64_MAX;
+            _cv.wait(lock);
+            continue;
+          }
+
+          const uint64_t now = _tick(std::chrono::steady_clock::now());
+          while ((_now < now) and (_count != 0))
+          {
+            _advance();
+          }
+
+          if (_count != 0)
+          {
+            _wake = _next_event();
+            _cv.wait_until(lock, _start + std::chrono::milliseconds(_wake));
+          }
+        }
+      }
+
+      const std::chrono::steady_clock::time_point _start;
+      uint64_t                                    _now   = 0;
+      uint64_t                                    _wake  = UINT64_MAX;
+      size_t                                      _count = 0;
+      _link                                       _heads[_levels][_slots];
+      std::mutex                                  _mtx;
+      std::condition_variable                     _cv;
+    };
+  }
+
+  class Timer final
+  {
+  public:
+    // constructs a handle to no task
+    Timer() noexcept = default;
+
+    inline Timer(Timer&& other) noexcept;
+    inline auto operator=(Timer&& other) noexcept -> Timer&;
+
+    // cancel the task if it is not due yet, true if it was cancelled
+    inline auto cancel() noexcept -> bool;
+
+    inline ~Timer() noexcept;
+
+  private:
+    friend class Pool;
+    explicit Timer(_nimata_impl::_timer* const timer_) noexcept : _entry(timer_) {}
+    _nimata_impl::_timer* _entry = nullptr;
+  };
+
+  Timer::Timer(Timer&& other_) noexcept :
+    _entry(other_._entry)
+  {
+    other_._entry = nullptr;
+  }
+
+  auto Timer::operator=(Timer&& other_) noexcept -> Timer&
+  {
+    if (this != &other_)
+    {
+      if (_entry)
+      {
+        _entry->_release();
+      }
+
+      _entry        = other_._entry;
+      other_._entry = nullptr;
+    }
+
+    return *this;
+  }
+
+  auto Timer::cancel() noexcept -> bool
+  {
+    return _entry ? _nimata_impl::_wheel::_instance()._cancel(_entry) : false;
+  }
+
+  Timer::~Timer() noexcept
+  {
+    if (_entry)
+    {
+      _entry->_release();
+    }
+  }
+
+  template<typename Rep, typename Period, typename Callable, typename... Arguments>
+  auto Pool::push_after
+  (
+    const std::chrono::duration<Rep, Period> delay_,
+    Callable&&                               callable_,
+    Arguments&&...                           arguments_
+  ) noexcept -> Timer
+  {
+    return push_at(std::chrono::steady_clock::now() + delay_,
+      std::forward<Callable>(callable_), std::forward<Arguments>(arguments_)...);
+  }
+
+  template<typename Clock, typename Duration, typename Callable, typename... Arguments>
+  auto Pool::push_at
+  (
+    const std::chrono::time_point<Clock, Duration> time_,
+    Callable&&                                     callable_,
+    Arguments&&...                                 arguments_
+  ) noexcept -> Timer
+  {
+    if _stz_impl_ABNORMAL(_nimata_impl::_validate_callable(callable_) == false)
+    {
+      _stz_impl_DBG_LVL_2(_stz_impl_DEBUG_MESSAGE("null task pushed.");)
+      return Timer();
+    }
+
+    // other clocks are mapped onto the steady clock as of now
+    const auto steady = std::chrono::steady_clock::now()
+      + std::chrono::duration_cast<std::chrono::steady_clock::duration>(time_ - Clock::now());
+
+    return _delay(steady, _nimata_impl::_bind(std::forward<Callable>(callable_), std::forward<Arguments>(arguments_)...));
+  }
+
+  auto Pool::_delay(const std::chrono::steady_clock::time_point time_, _nimata_impl::_task&& task_) noexcept -> Timer
+  {
+    _timed = true;
+
+    _nimata_impl::_timer* const timer = new _nimata_impl::_timer;
+    timer->_pool = this;
+    timer->_work = std::move(task_);
+
+    _nimata_impl::_wheel::_instance()._insert(timer, time_);
+
+    _stz_impl_DBG_LVL_2(_stz_impl_DEBUG_MESSAGE("pushed a delayed task.");)
+
+    return Timer(timer);
+  }
+
+  class Strand final
+  {
+  public:
+    // constructs a handle to no strand
+    Strand() noexcept = default;
+
+    inline Strand(Strand&& other) noexcept;
+    inline auto operator=(Strand&& other) noexcept -> Strand&;
+
+    // push 'callable(arguments...)', it runs after the tasks pushed before it and never concurrently with them
+    template<typename Callable, typename... Arguments>
+    void push(Callable&& callable, Arguments&&... arguments) noexcept;
+
+    inline ~Strand() noexcept;
+
+  private:
+    friend class Pool;
+    Strand(Pool* const pool_, _nimata_impl::_strand* const strand_) noexcept : _pool(pool_), _strand(strand_) {}
+    Pool*                  _pool   = nullptr;
+    _nimata_impl::_strand* _strand = nullptr;
+  };
+
+  Strand::Strand(Strand&& other_) noexcept :
+    _pool(other_._pool),
+    _strand(other_._strand)
+  {
+    other_._strand = nullptr;
+  }
+
+  auto Strand::operator=(Strand&& other_) noexcept -> Strand&
+  {
+    if (this != &other_)
+    {
+      if (_strand)
+      {
+        _pool->_keyed._release(_strand);
+      }
+
+      _pool          = other_._pool;
+      _strand        = other_._strand;
+      other_._strand = nullptr;
+    }
+
+    return *this;
+  }
+
+  template<typename Callable, typename... Arguments>
+  void Strand::push(Callable&& callable_, Arguments&&... arguments_) noexcept
+  {
+    if _stz_impl_ABNORMAL((_strand == nullptr) or (_nimata_impl::_validate_callable(callable_) == false))
+    {
+      _stz_impl_DBG_LVL_2(_stz_impl_DEBUG_MESSAGE("null task pushed.");)
+      return;
+    }
+
+    _pool->_serialize(_strand, _nimata_impl::_bind(std::forward<Callable>(callable_), std::forward<Arguments>(arguments_)...));
+  }
+
+  Strand::~Strand() noexcept
+  {
+    if (_strand)
+    {
+      _pool->_keyed._release(_strand);
+    }
+  }
+
+  template<typename Key>
+  auto Pool::strand(const Key& key_) noexcept -> Strand
+  {
+    return Strand(this, _keyed._acquire(std::hash<Key>()(key_)));
+  }
+
+  template<typename Key, typename Callable, typename... Arguments>
+  void Pool::push_keyed(const Key& key_, Callable&& callable_, Arguments&&... arguments_) noexcept
+  {
+    strand(key_).push(std::forward<Callable>(callable_), std::forward<Arguments>(arguments_)...);
+  }
+
+  void Pool::_serialize(_nimata_impl::_strand* const strand_, _nimata_impl::_task&& task_) noexcept
+  {
+    bool schedule;
+    {
+      std::lock_guard<std::mutex> lock(strand_->_queue_mtx);
+      strand_->_queue.push(std::move(task_));
+      schedule = not strand_->_scheduled;
+      strand_->_scheduled = true;
+    }
+
+    if (schedule)
+    {
+      ++strand_->_references;
+      _enqueue([this, strand_]{ _drain(strand_); });
+    }
+  }
+
+  // tasks run without the queue being locked, the drain goes back to the pool queue after a batch to let other work in
+  void Pool::_drain(_nimata_impl::_strand* const strand_) noexcept
+  {
+    for (unsigned k = 0; k < 32; ++k)
+    {
+      _nimata_impl::_task task;
+      {
+        std::lock_guard<std::mutex> lock(strand_->_queue_mtx);
+        if (strand_->_queue.empty())
+        {
+          strand_->_scheduled = false;
+          break;
+        }
+
+        task = std::move(strand_->_queue.front());
+        strand_->_queue.pop();
+      }
+
+      task();
+
+      if (k == 31)
+      {
+        _enqueue([this, strand_]{ _drain(strand_); });
+        return;
+      }
+    }
+
+    _keyed._release(strand_);
+  }
+
+  class Producer final
+  {
+  public:
+    // buffers the tasks pushed through it to 'pool', publishing them once 'capacity' of them are collected
+    inline Producer(Pool& pool, size_t capacity = 64) noexcept;
+
+    Producer(const Producer&) = delete;
+    auto operator=(const Producer&) -> Producer& = delete;
+
+    // same as Pool::push, the task is buffered until the next publication
+    template<Tracking tracking = Tracking::infer, typename Callable, typename... Arguments>
+    inline auto push
+    (
+      Callable&&     callable,
+      Arguments&&... arguments
+    ) noexcept -> _nimata_impl::_tracking<tracking, Callable, Arguments...>;
+
+    // publish buffered tasks to the pool
+    inline void flush() noexcept;
+
+    // publish buffered tasks then wait for all work of the pool to be done
+    inline void wait() noexcept;
+
+    // get the amount of buffered tasks
+    inline auto size() const noexcept -> size_t;
+
+    // publish buffered tasks
+    inline ~Producer() noexcept;
+
+  private:
+    Pool* const           _pool;
+    _nimata_impl::_buffer _buffer;
+  };
+
+  Producer::Producer(Pool& pool_, const size_t capacity_) noexcept
+    : _pool(&pool_)
+    , _buffer{&pool_, std::max<size_t>(capacity_, 1), {}}
+  {
+    _buffer._tasks.reserve(_buffer._capacity);
+  }
+
+  // the pool's push ends up in 'Pool::_submit', which diverts the task to the buffer of the calling thread
+  template<Tracking T, typename Callable, typename... Arguments>
+  auto Producer::push
+  (
+    Callable&&     callable_,
+    Arguments&&... arguments_
+  ) noexcept -> _nimata_impl::_tracking<T, Callable, Arguments...>
+  {
+    struct _divert final
+    {
+      _nimata_impl::_buffer* const _previous;
+      ~_divert() { _nimata_impl::_collector() = _previous; }
+    } divert{_nimata_impl::_collector()};
+
+    _nimata_impl::_collector() = &_buffer;
+
+    return _pool->push<T>(std::forward<Callable>(callable_), std::forward<Arguments>(arguments_)...);
+  }
+
+  void Producer::flush() noexcept
+  {
+    _pool->_publish(_buffer._tasks);
+  }
+
+  void Producer::wait() noexcept
+  {
+    flush();
+    _pool->wait();
+  }
+
+  auto Producer::size() const noexcept -> size_t
+  {
+    return _buffer._tasks.size();
+  }
+
+  Producer::~Producer() noexcept
+  {
+    flush();
+  }
+
+  void Pool::drain() noexcept
+  {
+    if (_timed)
+    {
+      _nimata_impl::_wheel::_instance()._forget(this);
+    }
+
+    wait();
+
+    while (_front._running != 0)
+    {
+      std::this_thread::sleep_for(std::chrono::nanoseconds(1));
+    }
+  }
+
+  // internal tasks such as continuations or fiber resumptions are kept, running tasks depend on them
+  auto Pool::abandon() noexcept -> size_t
+  {
+    if (_timed)
+    {
+      _nimata_impl::_wheel::_instance()._forget(this);
+    }
+
+    size_t discarded = 0;
+    std::vector<_nimata_impl::_task> dropped;
+    ++_front._abandoning;
+
+    // running tasks may push more work meanwhile, which is discarded as well
+    while (true)
+    {
+      _front._discard(dropped);
+      _keyed._discard(dropped);
+      discarded += dropped.size();
+      dropped.clear();
+
+      if (_front._pending == 0 or (_front._active == false and _front._running == 0))
+      {
+        break;
+      }
+
+      std::this_thread::sleep_for(std::chrono::nanoseconds(1));
+    }
+
+    --_front._abandoning;
+    return discarded + _front._dropped.exchange(0);
+  }
+
+  template<typename Rep, typename Period>
+  auto Pool::shutdown_for(const std::chrono::duration<Rep, Period> timeout_) noexcept -> bool
+  {
+    const auto deadline = std::chrono::steady_clock::now() + timeout_;
+
+    if (_timed)
+    {
+      _nimata_impl::_wheel::_instance()._forget(this);
+    }
+
+    while (_front._active and _front._pending != 0)
+    {
+      if (std::chrono::steady_clock::now() >= deadline)
+      {
+        return abandon() == 0;
+      }
+
+      std::this_thread::sleep_for(std::chrono::nanoseconds(1));
+    }
+
+    return abandon() == 0;
+  }
+
+  Pool::~Pool() noexcept
+  {
+    drain();
+
+    _arena->_detach(&_front);
+  }
+//*///------------------------------------------------------------------------------------------------------------------
+  template<typename Type>
+  class Pool::local final
+  {
+  public:
+    // one default-constructed 'Type' per worker of 'pool', constructed on first use
+    inline local(const Pool& pool) noexcept;
+
+    // one 'Type' per worker of 'pool' constructed from 'factory()' on first use
+    template<typename Factory>
+    inline local(const Pool& pool, Factory factory) noexcept;
+
+    local(const local&) = delete;
+    auto operator=(const local&) -> local& = delete;
+
+    // instance of the calling worker, threads that are not workers of the pool each get their own instance too
+    inline auto get() noexcept -> Type&;
+
+    inline auto operator*()  noexcept -> Type&;
+    inline auto operator->() noexcept -> Type*;
+
+    class iterator;
+
+    // iterate over the instances constructed so far
+    inline auto begin() noexcept -> iterator;
+    inline auto end()   noexcept -> iterator;
+
+    // fold the instances constructed so far into 'initial' using 'binary(initial, instance)'
+    template<typename Binary>
+    inline auto combine(Type initial, Binary binary) -> Type;
+
+    // destroy all instances, they will be constructed anew on next use
+    inline void clear() noexcept;
+
+    inline ~local() noexcept;
+
+  private:
+    // slots come in chunks that never move, so that workers added by resizing the arena get theirs safely
+    static constexpr unsigned _chunk  = 64;
+    static constexpr unsigned _chunks = 64;
+    static constexpr unsigned _limit  = _chunk * _chunks;
+    struct _slot final
+    {
+      std::unique_ptr<Type> _instance;
+      char                  _padding[_nimata_impl::_cache_line - sizeof(std::unique_ptr<Type>)];
+    };
+    using _registry = std::unordered_map<std::thread::id, std::unique_ptr<Type>>;
+    inline auto _at(unsigned index) noexcept -> _slot&;
+    inline void _reserve(unsigned count) noexcept;
+    const void* const      _arena;
+    std::atomic<_slot*>    _table[_chunks];
+    std::function<Type*()> _make;
+    std::mutex             _strangers_mtx;
+    _registry              _strangers; // instances of threads that are not workers of the arena
+  };
+
+  template<typename Type>
+  class Pool::local<Type>::iterator final
+  {
+  public:
+    iterator(local* const local_, const unsigned index_) noexcept
+      : _local(local_)
+      , _index(index_)
+      , _stranger(local_->_strangers.begin())
+    {
+      _skip();
+    }
+
+    auto operator*() const noexcept -> Type&
+    {
+      return *_instance();
+    }
+
+    auto operator->() const noexcept -> Type*
+    {
+      return _instance().get();
+    }
+
+    auto operator++() noexcept -> iterator&
+    {
+      if (_index < _limit)
+      {
+        ++_index;
+      }
+      else
+      {
+        ++_stranger;
+      }
+
+      _skip();
+      return *this;
+    }
+
+    bool operator!=(const iterator& other_) const noexcept
+    {
+      return not (*this == other_);
+    }
+
+    bool operator==(const iterator& other_) const noexcept
+    {
+      return _index == other_._index and _stranger == other_._stranger;
+    }
+
+  private:
+    friend class local;
+
+    // workers' instances come first, then those of other threads
+    auto _instance() const noexcept -> std::unique_ptr<Type>&
+    {
+      if (_index < _limit)
+      {
+        return _local->_table[_index / _chunk].load(std::memory_order_acquire)[_index % _chunk]._instance;
+      }
+
+      return _stranger->second;
+    }
+
+    void _skip() noexcept
+    {
+      while (_index < _limit)
+      {
+        if (_local->_table[_index / _chunk].load(std::memory_order_acquire) == nullptr)
+        {
+          _index = (_index / _chunk + 1) * _chunk;
+        }
+        else if (_instance() == nullptr)
+        {
+          ++_index;
+        }
+        else
+        {
+          return;
+        }
+      }
+
+      while (_stranger != _local->_strangers.end() and _stranger->second == nullptr)
+      {
+        ++_stranger;
+      }
+    }
+    local* const                  _local;
+    unsigned                      _index;
+    typename _registry::iterator  _stranger;
+  };
+
+  template<typename Type>
+  Pool::local<Type>::local(const Pool& pool_) noexcept
+    : _arena(pool_._arena)
+    , _make([]{ return new Type(); })
+  {
+    _reserve(pool_._arena->_capacity());
+  }
+
+  template<typename Type>
+  template<typename Factory>
+  Pool::local<Type>::local(const Pool& pool_, Factory factory_) noexcept
+    : _arena(pool_._arena)
+    , _make([=]{ return new Type(factory_()); })
+  {
+    _reserve(pool_._arena->_capacity());
+  }
+
+  template<typename Type>
+  auto Pool::local<Type>::get() noexcept -> Type&
+  {
+    const _nimata_impl::_identity& worker = _nimata_impl::_this_worker();
+
+    if _stz_impl_EXPECTED(worker._arena == _arena and static_cast<unsigned>(worker._index) < _limit)
+    {
+      _slot& slot = _at(static_cast<unsigned>(worker._index));
+      if _stz_impl_ABNORMAL(slot._instance == nullptr)
+      {
+        slot._instance.reset(_make());
+      }
+
+      return *slot._instance;
+    }
+
+    std::lock_guard<std::mutex> lock(_strangers_mtx);
+    std::unique_ptr<Type>& instance = _strangers[std::this_thread::get_id()];
+    if (instance == nullptr)
+    {
+      instance.reset(_make());
+    }
+
+    return *instance;
+  }
+
+  template<typename Type>
+  auto Pool::local<Type>::operator*() noexcept -> Type&
+  {
+    return get();
+  }
+
+  template<typename Type>
+  auto Pool::local<Type>::operator->() noexcept -> Type*
+  {
+    return &get();
+  }
+
+  template<typename Type>
+  auto Pool::local<Type>::begin() noexcept -> iterator
+  {
+    return iterator(this, 0);
+  }
+
+  template<typename Type>
+  auto Pool::local<Type>::end() noexcept -> iterator
+  {
+    iterator past(this, _limit);
+    past._stranger = _strangers.end();
+    return past;
+  }
+
+  template<typename Type>
+  template<typename Binary>
+  auto Pool::local<Type>::combine(Type initial_, Binary binary_) -> Type
+  {
+    for (Type& instance : *this)
+    {
+      initial_ = binary_(std::move(initial_), instance);
+    }
+
+    return initial_;
+  }
+
+  template<typename Type>
+  void Pool::local<Type>::clear() noexcept
+  {
+    for (std::atomic<_slot*>& chunk : _table)
+    {
+      _slot* const slots = chunk.load(std::memory_order_acquire);
+      for (unsigned k = 0; slots != nullptr and k < _chunk; ++k)
+      {
+        slots[k]._instance.reset();
+      }
+    }
+
+    std::lock_guard<std::mutex> lock(_strangers_mtx);
+    _strangers.clear();
+  }
+
+  template<typename Type>
+  Pool::local<Type>::~local() noexcept
+  {
+    for (std::atomic<_slot*>& chunk : _table)
+    {
+      delete[] chunk.load(std::memory_order_relaxed);
+    }
+  }
+
+  // a chunk missing because the arena grew is added by the first worker that needs it
+  template<typename Type>
+  auto Pool::local<Type>::_at(const unsigned index_) noexcept -> _slot&
+  {
+    std::atomic<_slot*>& chunk = _table[index_ / _chunk];
+
+    _slot* slots = chunk.load(std::memory_order_acquire);
+    if _stz_impl_ABNORMAL(slots == nullptr)
+    {
+      _slot* const fresh = new _slot[_chunk];
+      if (chunk.compare_exchange_strong(slots, fresh, std::memory_order_acq_rel))
+      {
+        slots = fresh;
+      }
+      else
+      {
+        delete[] fresh;
+      }
+    }
+
+    return slots[index_ % _chunk];
+  }
+
+  template<typename Type>
+  void Pool::local<Type>::_reserve(const unsigned count_) noexcept
+  {
+    for (unsigned k = 0; k < _chunks; ++k)
+    {
+      _table[k].store(k * _chunk < count_ ? new _slot[_chunk] : nullptr, std::memory_order_relaxed);
+    }
+  }
+//*///------------------------------------------------------------------------------------------------------------------
+  template<typename Type>
+  Future<Type>::Future(_state* const state_) noexcept
+    : _shared(state_)
+  {}
+
+  template<typename Type>
+  Future<Type>::Future(Future&& other_) noexcept
+    : _shared(other_._shared)
+  {
+    other_._shared = nullptr;
+  }
+
+  template<typename Type>
+  auto Future<Type>::operator=(Future&& other_) noexcept -> Future&
+  {
+    if (this != &other_)
+    {
+      if (_shared)
+      {
+        _shared->_release();
+      }
+
+      _shared = other_._shared;
+      other_._shared = nullptr;
+    }
+
+    return *this;
+  }
+
+  template<typename Type>
+  bool Future<Type>::valid() const noexcept
+  {
+    return _shared != nullptr;
+  }
+
+  template<typename Type>
+  bool Future<Type>::ready() const noexcept
+  {
+    return _shared and _shared->_is_ready();
+  }
+
+  template<typename Type>
+  void Future<Type>::wait() const noexcept
+  {
+    if _stz_impl_ABNORMAL(_shared == nullptr)
+    {
+      return;
+    }
+
+# if defined(_stz_impl_FIBERS)
+    // a fiber is resumed by the continuation of the shared state
+    if (_nimata_impl::_fiber::_suspendable() and _shared->_is_ready() == false)
+    {
+      _state* const state = _shared;
+      _nimata_impl::_fiber* const fiber = _nimata_impl::_fiber::_current();
+
+      _nimata_impl::_fiber::_suspend([state, fiber]{
+        state->_then(new _nimata_impl::_task([fiber]{ _nimata_impl::_fiber::_wake(fiber); }));
+      });
+    }
+# endif
+
+    while (_shared->_is_ready() == false)
+    {
+      std::this_thread::sleep_for(std::chrono::nanoseconds(1));
+    }
+  }
+
+  template<typename Type>
+  bool Future<Type>::broken() const noexcept
+  {
+    return _shared and _shared->_is_broken();
+  }
+
+  template<typename Type>
+  auto Future<Type>::get() -> Type
+  {
+    if _stz_impl_ABNORMAL(_shared == nullptr)
+    {
+      throw std::future_error(std::future_errc::no_state);
+    }
+
+    wait();
+
+    _state* const state = _shared;
+    _shared = nullptr;
+
+    struct _releaser final
+    {
+      _state* const _releasing;
+      ~_releaser() noexcept { _releasing->_release(); }
+    } releaser = {state};
+
+    if _stz_impl_ABNORMAL(state->_is_broken())
+    {
+      throw std::future_error(std::future_errc::broken_promise);
+    }
+
+    return static_cast<Type>(std::move(state->_value()));
+  }
+
+  template<typename Type>
+  template<typename Callable>
+  auto Future<Type>::then(Pool& pool_, Callable&& callable_) noexcept -> Future<typename _nimata_impl::_next<
+    typename std::decay<Callable>::type, _nimata_impl::_stored<Type>>::type>
+  {
+    using Next   = _nimata_impl::_next<typename std::decay<Callable>::type, _nimata_impl::_stored<Type>>;
+    using Result = typename Next::type;
+    using State  = _nimata_impl::_state<_nimata_impl::_stored<Result>>;
+
+    if _stz_impl_ABNORMAL(_shared == nullptr)
+    {
+      return Future<Result>();
+    }
+
+    State* const   next     = new State;
+    _state* const  state    = _shared;
+    Pool* const    pool     = &pool_;
+    typename std::decay<Callable>::type callable = std::forward<Callable>(callable_);
+    _shared = nullptr;
+
+    // the continuation does not run the callable itself, it only hands it to the pool
+    state->_then(new _nimata_impl::_task([=]{
+      if (state->_is_broken())
+      {
+        next->_break();
+        next->_release();
+        state->_release();
+        return;
+      }
+
+      pool->_enqueue([=]() mutable {
+        Next::_impl(next, callable, state);
+        state->_release();
+      });
+    }));
+
+    return Future<Result>(next);
+  }
+
+  template<typename Type>
+  Future<Type>::~Future() noexcept
+  {
+    if (_shared)
+    {
+      _shared->_release();
+    }
+  }
+//*///------------------------------------------------------------------------------------------------------------------
+  template<typename Sequence>
+  struct WhenAny final
+  {
+    size_t   index; // -1 if 'futures' is empty
+    Sequence futures;
+  };
+
+  namespace _nimata_impl
+  {
+    struct _combine final
+    {
+      template<typename Type>
+      static
+      auto _state_of(Future<Type>& future_) noexcept -> _state_base*
+      {
+        return future_._shared;
+      }
+
+      template<typename Type>
+      static
+      auto _future_of(_state<Type>* const state_) noexcept -> Future<Type>
+      {
+        return Future<Type>(state_);
+      }
+
+      // every state reports to 'block' on the thread that readies it, the last report comes from the caller
+      // an invalid future has no state and reports at once, as if it were ready
+      template<typename Block>
+      static
+      void _watch(_state_base* const states_[], const size_t count_, Block* const block_) noexcept
+      {
+        for (size_t k = 0; k < count_; ++k)
+        {
+          if _stz_impl_ABNORMAL(states_[k] == nullptr)
+          {
+            block_->_arrive(k);
+            continue;
+          }
+
+          states_[k]->_then(new _task([block_, k]{ block_->_arrive(k); }));
+        }
+
+        block_->_arrive(count_);
+      }
+    };
+
+    template<typename Sequence>
+    struct _all final
+    {
+      void _arrive(size_t) noexcept
+      {
+        if (--_countdown == 0)
+        {
+          _result->_set(std::move(_futures));
+          _result->_release();
+          delete this;
+        }
+      }
+
+      Sequence           _futures;
+      std::atomic_size_t _countdown;
+      _state<Sequence>*  _result;
+    };
+
+    template<typename Sequence>
+    struct _any final
+    {
+      void _arrive(const size_t k_) noexcept
+      {
+        if ((k_ < _count or _count == 0) and _won.exchange(true) == false)
+        {
+          _result->_set(WhenAny<Sequence>{_count == 0 ? static_cast<size_t>(-1) : k_, std::move(_futures)});
+          _result->_release();
+        }
+
+        if (--_countdown == 0)
+        {
+          delete this;
+        }
+      }
+
+      Sequence                    _futures;
+      const size_t                _count;
+      std::atomic_size_t          _countdown;
+      std::atomic_bool            _won;
+      _state<WhenAny<Sequence>>*  _result;
+    };
+
+    template<typename Sequence>
+    auto _when_all(Sequence&& futures_, _state_base* const states_[], const size_t count_) noexcept -> Future<Sequence>
+    {
+      _state<Sequence>* const result = new _state<Sequence>;
+      Future<Sequence>        future = _combine::_future_of(result);
+
+      _all<Sequence>* const block = new _all<Sequence>{std::move(futures_), {count_ + 1}, result};
+      _combine::_watch(states_, count_, block);
+
+      return future;
+    }
+
+    template<typename Sequence>
+    auto _when_any(Sequence&& futures_, _state_base* const states_[], const size_t count_) noexcept
+      -> Future<WhenAny<Sequence>>
+    {
+      _state<WhenAny<Sequence>>* const result = new _state<WhenAny<Sequence>>;
+      Future<WhenAny<Sequence>>        future = _combine::_future_of(result);
+
+      _any<Sequence>* const block = new _any<Sequence>{std::move(futures_), count_, {count_ + 1}, {false}, result};
+      _combine::_watch(states_, count_, block);
+
+      return future;
+    }
+  }
+
+  template<typename... Types>
+  auto when_all(Future<Types>&&... futures_) noexcept -> Future<std::tuple<Future<Types>...>>
+  {
+    _nimata_impl::_state_base* const states[] = {_nimata_impl::_combine::_state_of(futures_)..., nullptr};
+
+    return _nimata_impl::_when_all(std::tuple<Future<Types>...>(std::move(futures_)...), states, sizeof...(Types));
+  }
+
+  template<typename Type>
+  auto when_all(std::vector<Future<Type>> futures_) noexcept -> Future<std::vector<Future<Type>>>
+  {
+    std::vector<_nimata_impl::_state_base*> states;
+    for (Future<Type>& future : futures_)
+    {
+      states.push_back(_nimata_impl::_combine::_state_of(future));
+    }
+
+    return _nimata_impl::_when_all(std::move(futures_), states.data(), states.size());
+  }
+
+  template<typename... Types>
+  auto when_any(Future<Types>&&... futures_) noexcept -> Future<WhenAny<std::tuple<Future<Types>...>>>
+  {
+    _nimata_impl::_state_base* const states[] = {_nimata_impl::_combine::_state_of(futures_)..., nullptr};
+
+    return _nimata_impl::_when_any(std::tuple<Future<Types>...>(std::move(futures_)...), states, sizeof...(Types));
+  }
+
+  template<typename Type>
+  auto when_any(std::vector<Future<Type>> futures_) noexcept -> Future<WhenAny<std::vector<Future<Type>>>>
+  {
+    std::vector<_nimata_impl::_state_base*> states;
+    for (Future<Type>& future : futures_)
+    {
+      states.push_back(_nimata_impl::_combine::_state_of(future));
+    }
+
+    return _nimata_impl::_when_any(std::move(futures_), states.data(), states.size());
+  }
+//*///------------------------------------------------------------------------------------------------------------------
+  class TaskGraph final
+  {
+  public:
+    using Node = size_t;
+
+    // add a node running 'callable()'
+    template<typename Callable>
+    inline auto node(Callable&& callable) noexcept -> Node;
+
+    // 'after' only starts once 'before' is done, the graph must stay acyclic
+    inline void precede(Node before, Node after) noexcept;
+
+    // push nodes to 'pool' as soon as their predecessors are done, one run at a time
+    inline auto run(Pool& pool) noexcept -> Future<void>;
+
+    // get amount of nodes
+    inline auto size() const noexcept -> size_t;
+
+  private:
+    struct _node final
+    {
+      _nimata_impl::_task _work;
+      std::vector<Node>   _successors;
+      unsigned            _predecessors = 0;
+      std::atomic_uint    _remaining    = {0};
+    };
+    inline void _execute(Pool* pool, Node node) noexcept;
+    std::vector<std::unique_ptr<_node>>       _nodes;
+    std::atomic_size_t                        _left  = {0};
+    _nimata_impl::_state<_nimata_impl::_none>* _done = nullptr;
+  };
+
+  template<typename Callable>
+  auto TaskGraph::node(Callable&& callable_) noexcept -> Node
+  {
+    _nodes.emplace_back(new _node);
+    _nodes.back()->_work = std::forward<Callable>(callable_);
+
+    return _nodes.size() - 1;
+  }
+
+  void TaskGraph::precede(const Node before_, const Node after_) noexcept
+  {
+    _nodes[before_]->_successors.push_back(after_);
+    ++_nodes[after_]->_predecessors;
+  }
+
+  auto TaskGraph::run(Pool& pool_) noexcept -> Future<void>
+  {
+    _done = new _nimata_impl::_state<_nimata_impl::_none>;
+    Future<void> future(_done);
+
+    if _stz_impl_ABNORMAL(_nodes.empty())
+    {
+      _done->_set();
+      _done->_release();
+      return future;
+    }
+
+    _left = _nodes.size();
+    for (const std::unique_ptr<_node>& node : _nodes)
+    {
+      node->_remaining = node->_predecessors;
+    }
+
+    for (Node k = 0; k < _nodes.size(); ++k)
+    {
+      if (_nodes[k]->_predecessors == 0)
+      {
+        Pool* const pool = &pool_;
+        pool->_enqueue([this, pool, k]{ _execute(pool, k); });
+      }
+    }
+
+    _stz_impl_DBG_LVL_2(_stz_impl_DEBUG_MESSAGE("graph of %zu nodes launched.", _nodes.size());)
+
+    return future;
+  }
+
+  auto TaskGraph::size() const noexcept -> size_t
+  {
+    return _nodes.size();
+  }
+
+  void TaskGraph::_execute(Pool* const pool_, Node node_) noexcept
+  {
+    while (true)
+    {
+      _nodes[node_]->_work();
+
+      // one ready successor is kept on this worker instead of going through the queue
+      bool kept = false;
+      for (const Node successor : _nodes[node_]->_successors)
+      {
+        if (--_nodes[successor]->_remaining == 0)
+        {
+          if (not kept)
+          {
+            kept  = true;
+            node_ = successor;
+          }
+          else
+          {
+            pool_->_enqueue([this, pool_, successor]{ _execute(pool_, successor); });
+          }
+        }
+      }
+
+      // once the last node is done the graph may be gone, so nothing of it is read past this point
+      _nimata_impl::_state<_nimata_impl::_none>* const done = _done;
+      if (--_left == 0)
+      {
+        done->_set();
+        done->_release();
+        return;
+      }
+
+      if (not kept)
+      {
+        return;
+      }
+    }
+  }
+//*///------------------------------------------------------------------------------------------------------------------
+  class TaskGroup final
+  {
+  public:
+    // children are pushed to 'pool'
+    inline explicit TaskGroup(Pool& pool) noexcept;
+
+    // run 'callable()' concurrently with the rest of the scope
+    template<typename Callable>
+    void spawn(Callable&& callable) noexcept;
+
+    // run the children no worker claimed yet, newest first, then run queued tasks of the pool until the others are done
+    inline void sync() noexcept;
+
+    // syncs
+    inline ~TaskGroup() noexcept;
+
+  private:
+    // children offered to the pool are stacked through nodes that are recycled per thread rather than allocated
+    struct _child final
+    {
+      _nimata_impl::_task _work;
+      _child*             _next       = nullptr;
+      std::atomic_bool    _claimed    = {false};
+      std::atomic_uint    _references = {2}; // scope and pool queue
+    };
+    static constexpr unsigned _inline = 4;
+    static constexpr unsigned _block  = 64;
+    static inline auto _nodes() noexcept -> std::vector<std::unique_ptr<_child>>&;
+    static inline auto _acquire() noexcept -> _child*;
+    static inline void _release(_child* child) noexcept;
+    inline auto _keep() noexcept -> _nimata_impl::_task&;
+    static inline void _run(_child* child, std::atomic_size_t* left) noexcept;
+    Pool* const                                         _pool;
+    _child*                                             _offered = nullptr; // offered to the pool, newest first
+    _nimata_impl::_task                                 _first[_inline];    // first children kept for 'sync' to run
+    std::vector<std::unique_ptr<_nimata_impl::_task[]>> _blocks;            // children kept past the first ones
+    size_t                                              _kept    = 0;
+    std::atomic_size_t                                  _left    = {0};     // offered children not done yet
+  };
+
+  TaskGroup::TaskGroup(Pool& pool_) noexcept :
+    _pool(&pool_)
+  {}
+
+  template<typename Callable>
+  void TaskGroup::spawn(Callable&& callable_) noexcept
+  {
+    // children are only offered to the pool while it has idle workers, the others are run by 'sync'
+    if (_pool->_front._pending >= _pool->size())
+    {
+      _keep() = std::forward<Callable>(callable_);
+      return;
+    }
+
+    _child* const child = _acquire();
+    child->_work = std::forward<Callable>(callable_);
+    child->_next = _offered;
+    _offered     = child;
+
+    // the queued task does not refer to the scope, which may be gone by the time it runs
+    std::atomic_size_t* const left = &_left;
+    ++_left;
+    _pool->_enqueue([left, child]{ _run(child, left); });
+  }
+
+  void TaskGroup::sync() noexcept
+  {
+    for (; _kept != 0; --_kept)
+    {
+      _nimata_impl::_task& work = _kept <= _inline ? _first[_kept - 1]
+                                                   : _blocks[(_kept - 1 - _inline) / _block][(_kept - 1 - _inline) % _block];
+      work();
+      work = nullptr;
+    }
+
+    while (_offered != nullptr)
+    {
+      _child* const child = _offered;
+      _offered = child->_next;
+      _run(child, &_left);
+    }
+
+    // the pool's queue is worked through meanwhile, it holds the children no worker claimed yet
+    while (_left != 0)
+    {
+      if (_pool->_front._help() == false)
+      {
+        std::this_thread::yield();
+      }
+    }
+  }
+
+  TaskGroup::~TaskGroup() noexcept
+  {
+    sync();
+  }
+
+  auto TaskGroup::_nodes() noexcept -> std::vector<std::unique_ptr<_child>>&
+  {
+    static thread_local std::vector<std::unique_ptr<_child>> cache;
+    return cache;
+  }
+
+  auto TaskGroup::_acquire() noexcept -> _child*
+  {
+    std::vector<std::unique_ptr<_child>>& cache = _nodes();
+    if _stz_impl_ABNORMAL(cache.empty())
+    {
+      return new _child;
+    }
+
+    _child* const child = cache.back().release();
+    cache.pop_back();
+    child->_claimed.store(false, std::memory_order_relaxed);
+    child->_references.store(2, std::memory_order_relaxed);
+
+    return child;
+  }
+
+  // nodes go back to the cache of the thread dropping them last, which keeps a bounded amount of them
+  void TaskGroup::_release(_child* const child_) noexcept
+  {
+    if (child_->_references.fetch_sub(1, std::memory_order_acq_rel) != 1)
+    {
+      return;
+    }
+
+    std::vector<std::unique_ptr<_child>>& cache = _nodes();
+    if (cache.size() < 64)
+    {
+      cache.emplace_back(child_);
+    }
+    else
+    {
+      delete child_;
+    }
+  }
+
+  // the first children are stored in the scope itself, blocks are only added past them and kept until destruction
+  auto TaskGroup::_keep() noexcept -> _nimata_impl::_task&
+  {
+    const size_t index = _kept++;
+    if _stz_impl_EXPECTED(index < _inline)
+    {
+      return _first[index];
+    }
+
+    const size_t chunk = (index - _inline) / _block;
+    if _stz_impl_ABNORMAL(chunk == _blocks.size())
+    {
+      _blocks.emplace_back(new _nimata_impl::_task[_block]);
+    }
+
+    return _blocks[chunk][(index - _inline) % _block];
+  }
+
+  // whoever claims the child first runs it, 'left' belongs to the scope and is only touched by the claimer
+  void TaskGroup::_run(_child* const child_, std::atomic_size_t* const left_) noexcept
+  {
+    if (child_->_claimed.exchange(true) == false)
+    {
+      child_->_work();
+      child_->_work = nullptr;
+      --*left_;
+    }
+
+    _release(child_);
+  }
+
+  namespace _nimata_impl
+  {
+    inline
+    void _invoke(TaskGroup&) noexcept
+    {}
+
+    template<typename Callable, typename... Callables>
+    void _invoke(TaskGroup& group_, Callable&& callable_, Callables&&... callables_) noexcept
+    {
+      group_.spawn(std::forward<Callable>(callable_));
+      _invoke(group_, std::forward<Callables>(callables_)...);
+    }
+  }
+
+  template<typename... Callables>
+  void parallel_invoke(Pool& pool_, Callables&&... callables_) noexcept
+  {
+    TaskGroup group(pool_);
+    _nimata_impl::_invoke(group, std::forward<Callables>(callables_)...);
+    group.sync();
+  }
+//*///------------------------------------------------------------------------------------------------------------------
+  class Pipeline final
+  {
+  public:
+    // at most 'tokens' items are in flight at once
+    inline explicit Pipeline(size_t tokens) noexcept;
+
+    // first stage, serial, 'callable(item)' fills 'item' and returns false once the input is exhausted
+    template<typename Type, typename Callable>
+    auto source(Callable&& callable) noexcept -> _nimata_impl::_pipe<Type>;
+
+    // stream every item through the stages using 'pool', one run at a time
+    inline auto run(Pool& pool) noexcept -> Future<void>;
+
+    // get the maximum amount of items in flight
+    inline auto tokens() const noexcept -> size_t;
+
+  private:
+    template<typename> friend class _nimata_impl::_pipe;
+    struct _cargo
+    {
+      virtual ~_cargo() noexcept = default;
+    };
+    template<typename Type>
+    struct _boxed final : public _cargo
+    {
+      template<typename... Arguments>
+      _boxed(Arguments&&... arguments_) : _value(std::forward<Arguments>(arguments_)...) {}
+      Type _value;
+    };
+    struct _token final
+    {
+      std::unique_ptr<_cargo> _item;
+      size_t                 _seq   = 0;
+      size_t                 _stage = 0;
+    };
+    struct _stage final
+    {
+      std::function<bool(std::unique_ptr<_cargo>&)>                 _work;
+      Stage                                                         _mode;
+      bool                                                          _ordered = false;
+      std::mutex                                                    _mtx;
+      bool                                                          _busy    = false;
+      size_t                                                        _next    = 0;
+      std::queue<_token*>                                           _fifo;
+      std::vector<_token*>                                          _window; // waiting tokens of an ordered stage, by sequence number
+    };
+    inline auto _enter(_token* token) noexcept -> _token*;
+    inline auto _ready(_stage& stage) noexcept -> _token*;
+    inline void _leave(_stage& stage) noexcept;
+    inline void _execute(_token* token) noexcept;
+    const size_t                               _tokens;
+    std::vector<std::unique_ptr<_stage>>       _stages;
+    Pool*                                      _pool   = nullptr;
+    bool                                       _ended  = false;
+    size_t                                     _issued = 0;
+    std::atomic_size_t                         _live   = {0};
+    _nimata_impl::_state<_nimata_impl::_none>* _done   = nullptr;
+  };
+
+  namespace _nimata_impl
+  {
+    // builder of the stages of a pipeline whose current items are of type 'Type'
+    template<typename Type>
+    class _pipe final
+    {
+    public:
+      // add a stage running 'callable(item)' on each item, its result is the item of the next stage
+      template<typename Callable>
+      auto stage(const Stage mode_, Callable&& callable_) noexcept
+        -> _pipe<decltype(std::declval<typename std::decay<Callable>::type&>()(std::declval<Type>()))>
+      {
+        using Result = decltype(std::declval<typename std::decay<Callable>::type&>()(std::declval<Type>()));
+
+        _pipeline->_stages.emplace_back(new Pipeline::_stage);
+        _pipeline->_stages.back()->_mode = mode_;
+        _pipeline->_stages.back()->_work = _apply<typename std::decay<Callable>::type, Result>(
+          std::forward<Callable>(callable_), std::is_same<Result, Type>());
+
+        return _pipe<Result>(_pipeline);
+      }
+
+    private:
+      template<typename> friend class _pipe;
+      friend class stz::Pipeline;
+      explicit _pipe(Pipeline* const pipeline_) noexcept : _pipeline(pipeline_) {}
+
+      // items keeping their type are updated in place
+      template<typename Callable, typename Result>
+      static
+      auto _apply(Callable callable_, std::true_type) noexcept -> std::function<bool(std::unique_ptr<Pipeline::_cargo>&)>
+      {
+        return [callable_](std::unique_ptr<Pipeline::_cargo>& item_) mutable -> bool
+        {
+          Type& value = static_cast<Pipeline::_boxed<Type>&>(*item_)._value;
+          value = callable_(std::move(value));
+          return true;
+        };
+      }
+
+      template<typename Callable, typename Result>
+      static
+      auto _apply(Callable callable_, std::false_type) noexcept -> std::function<bool(std::unique_ptr<Pipeline::_cargo>&)>
+      {
+        return [callable_](std::unique_ptr<Pipeline::_cargo>& item_) mutable -> bool
+        {
+          _pipe::_replace<Result>(item_, callable_, std::move(static_cast<Pipeline::_boxed<Type>&>(*item_)._value));
+          return true;
+        };
+      }
+
+      template<typename Result, typename Callable, typename Value>
+      static
+      auto _replace(std::unique_ptr<Pipeline::_cargo>& item_, Callable& callable_, Value&& value_) noexcept
+        -> typename std::enable_if<std::is_void<Result>::value == false>::type
+      {
+        item_.reset(new Pipeline::_boxed<Result>(callable_(std::forward<Value>(value_))));
+      }
+
+      template<typename Result, typename Callable, typename Value>
+      static
+      auto _replace(std::unique_ptr<Pipeline::_cargo>& item_, Callable& callable_, Value&& value_) noexcept
+        -> typename std::enable_if<std::is_void<Result>::value>::type
+      {
+        callable_(std::forward<Value>(value_));
+        item_.reset();
+      }
+
+      Pipeline* _pipeline;
+    };
+  }
+
+  Pipeline::Pipeline(const size_t tokens_) noexcept :
+    _tokens(tokens_ == 0 ? 1 : tokens_)
+  {}
+
+  template<typename Type, typename Callable>
+  auto Pipeline::source(Callable&& callable_) noexcept -> _nimata_impl::_pipe<Type>
+  {
+    using Source = typename std::decay<Callable>::type;
+
+    _stages.clear();
+    _stages.emplace_back(new _stage);
+    _stages.back()->_mode = serial_unordered;
+
+    Source source = std::forward<Callable>(callable_);
+    _stages.back()->_work = [source](std::unique_ptr<_cargo>& item_) mutable -> bool
+    {
+      _boxed<Type>* const boxed = new _boxed<Type>();
+      item_.reset(boxed);
+      return static_cast<bool>(source(boxed->_value));
+    };
+
+    return _nimata_impl::_pipe<Type>(this);
+  }
+
+  auto Pipeline::run(Pool& pool_) noexcept -> Future<void>
+  {
+    _done = new _nimata_impl::_state<_nimata_impl::_none>;
+    Future<void> future(_done);
+
+    if _stz_impl_ABNORMAL(_stages.empty())
+    {
+      _done->_set();
+      _done->_release();
+      return future;
+    }
+
+    _pool   = &pool_;
+    _ended  = false;
+    _issued = 0;
+    _live   = _tokens;
+    for (size_t k = 0; k < _stages.size(); ++k)
+    {
+      _stages[k]->_busy    = false;
+      _stages[k]->_next    = 0;
+      _stages[k]->_window.assign(_tokens, nullptr);
+      _stages[k]->_ordered = (k != 0) and ((_stages[k]->_mode == serial) or (_stages[k - 1]->_mode == parallel_ordered));
+    }
+
+    // every token starts waiting on the source, which hands out the first one right away
+    for (size_t k = 0; k < _tokens; ++k)
+    {
+      _token* const token = _enter(new _token);
+      if (token)
+      {
+        _pool->_enqueue([this, token]{ _execute(token); });
+      }
+    }
+
+    _stz_impl_DBG_LVL_2(_stz_impl_DEBUG_MESSAGE("pipeline of %zu stages launched.", _stages.size());)
+
+    return future;
+  }
+
+  auto Pipeline::tokens() const noexcept -> size_t
+  {
+    return _tokens;
+  }
+
+  auto Pipeline::_enter(_token* const token_) noexcept -> _token*
+  {
+    _stage&    stage    = *_stages[token_->_stage];
+    const bool concurrent = (stage._mode == parallel) or (stage._mode == parallel_ordered);
+
+    if (concurrent and not stage._ordered)
+    {
+      return token_;
+    }
+
+    std::lock_guard<std::mutex> lock(stage._mtx);
+
+    if (stage._ordered)
+    {
+      // at most '_tokens' items are in flight, so those waiting here are less than '_tokens' apart
+      stage._window[token_->_seq % _tokens] = token_;
+    }
+    else
+    {
+      stage._fifo.push(token_);
+    }
+
+    if (concurrent)
+    {
+      // release every token that is next in order, all but one go through the pool queue
+      _token* const first = _ready(stage);
+      if (first)
+      {
+        while (_token* const other = _ready(stage))
+        {
+          _pool->_enqueue([this, other]{ _execute(other); });
+        }
+      }
+
+      return first;
+    }
+
+    if (stage._busy)
+    {
+      return nullptr;
+    }
+
+    _token* const next = _ready(stage);
+    stage._busy = (next != nullptr);
+
+    return next;
+  }
+
+  auto Pipeline::_ready(_stage& stage_) noexcept -> _token*
+  {
+    _token* token = nullptr;
+
+    if (stage_._ordered)
+    {
+      _token*& waiting = stage_._window[stage_._next % _tokens];
+      if (waiting != nullptr)
+      {
+        token   = waiting;
+        waiting = nullptr;
+        ++stage_._next;
+      }
+    }
+    else if (stage_._fifo.empty() == false)
+    {
+      token = stage_._fifo.front();
+      stage_._fifo.pop();
+    }
+
+    return token;
+  }
+
+  void Pipeline::_leave(_stage& stage_) noexcept
+  {
+    _token* next;
+    {
+      std::lock_guard<std::mutex> lock(stage_._mtx);
+      next = _ready(stage_);
+      stage_._busy = (next != nullptr);
+    }
+
+    if (next)
+    {
+      _pool->_enqueue([this, next]{ _execute(next); });
+    }
+  }
+
+  void Pipeline::_execute(_token* token_) noexcept
+  {
+    while (token_)
+    {
+      _stage& stage = *_stages[token_->_stage];
+
+      if (token_->_stage == 0)
+      {
+        const bool more = (_ended == false) and stage._work(token_->_item);
+
+        if (more)
+        {
+          token_->_seq = _issued++;
+        }
+        else
+        {
+          _ended = true;
+        }
+
+        _leave(stage);
+
+        if (not more)
+        {
+          delete token_;
+
+          if (--_live == 0)
+          {
+            _nimata_impl::_state<_nimata_impl::_none>* const done = _done;
+            done->_set();
+            done->_release();
+          }
+
+          return;
+        }
+      }
+      else
+      {
+        stage._work(token_->_item);
+
+        if ((stage._mode == serial) or (stage._mode == serial_unordered))
+        {
+          _leave(stage);
+        }
+      }
+
+      // the last stage hands the token back to the source
+      token_->_stage = (token_->_stage + 1) % _stages.size();
+      token_         = _enter(token_);
+    }
+  }
+//*///------------------------------------------------------------------------------------------------------------------
+  template<typename Type>
+  class Channel final
+  {
+  public:
+    // hold at most 'capacity' values at once
+    inline explicit Channel(size_t capacity) noexcept;
+
+    // send 'value' if there is room and the channel is open, 'value' is left untouched otherwise
+    template<typename Value>
+    auto try_send(Value&& value) noexcept -> bool;
+
+    // send 'value' once there is room, false if the channel is closed
+    template<typename Value>
+    auto send(Value&& value) noexcept -> bool;
+
+    // receive into 'value' if a value is available
+    inline auto try_recv(Type& value) noexcept -> bool;
+
+    // receive into 'value' once a value is available, false if the channel is closed and empty
+    inline auto recv(Type& value) noexcept -> bool;
+
+    // refuse further sends, values already sent can still be received
+    inline void close() noexcept;
+
+    // check if the channel is closed
+    inline auto closed() const noexcept -> bool;
+
+    // run 'callable(value)' on 'pool' for every value sent, one value at a time, at most once per channel
+    template<typename Callable>
+    void receive(Pool& pool, Callable&& callable) noexcept;
+
+    // get approximate amount of values held
+    inline auto size() const noexcept -> size_t;
+
+    // get maximum amount of values held
+    inline auto capacity() const noexcept -> size_t;
+
+    inline ~Channel() noexcept;
+
+  private:
+    struct _cell final
+    {
+      std::atomic_size_t _seq;
+      typename std::aligned_storage<sizeof(Type), alignof(Type)>::type _storage;
+    };
+    struct _receiver final
+    {
+      Pool*                     _pool;
+      std::function<void(Type&)> _callable;
+    };
+    template<typename Consumer>
+    auto _pop(Consumer&& consumer) noexcept -> bool;
+    inline auto _available() const noexcept -> bool;
+    inline void _notify() noexcept;
+    inline void _drain(_receiver* listener) noexcept;
+    const size_t             _capacity;
+    const size_t             _ring;     // cells, at least 2 so that a full cell and a free one never share a sequence
+    std::unique_ptr<_cell[]> _cells;
+    std::atomic_bool         _closed    = {false};
+    std::atomic<_receiver*>  _listener  = {nullptr};
+    std::atomic_bool         _scheduled = {false};
+    std::atomic_uint         _drains    = {0};
+    char                     _padding_0[_nimata_impl::_cache_line];
+    std::atomic_size_t       _tail      = {0};
+    char                     _padding_1[_nimata_impl::_cache_line - sizeof(std::atomic_size_t)];
+    std::atomic_size_t       _head      = {0};
+    char                     _padding_2[_nimata_impl::_cache_line - sizeof(std::atomic_size_t)];
+  };
+
+  template<typename Type>
+  Channel<Type>::Channel(const size_t capacity_) noexcept :
+    _capacity(capacity_ == 0 ? 1 : capacity_),
+    _ring(_capacity == 1 ? 2 : _capacity),
+    _cells(new _cell[_ring])
+  {
+    for (size_t k = 0; k < _ring; ++k)
+    {
+      _cells[k]._seq.store(k, std::memory_order_relaxed);
+    }
+  }
+
+  template<typename Type>
+  template<typename Value>
+  auto Channel<Type>::try_send(Value&& value_) noexcept -> bool
+  {
+    if _stz_impl_ABNORMAL(_closed.load(std::memory_order_acquire))
+    {
+      return false;
+    }
+
+    // each cell's sequence tells whose turn it is: 'position' to send, 'position + 1' to receive
+    size_t position = _tail.load(std::memory_order_relaxed);
+    _cell* cell;
+    while (true)
+    {
+      cell = &_cells[position % _ring];
+      const size_t seq  = cell->_seq.load(std::memory_order_acquire);
+      const auto   diff = static_cast<std::ptrdiff_t>(seq - position);
+
+      if (diff == 0)
+      {
+        // a ring larger than the capacity only has room while fewer than 'capacity' values are held
+        if (_ring != _capacity)
+        {
+          const size_t head = _head.load(std::memory_order_acquire);
+          if (head > position)
+          {
+            position = _tail.load(std::memory_order_relaxed);
+            continue;
+          }
+
+          if (position - head >= _capacity)
+          {
+            return false;
+          }
+        }
+
+        if (_tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+        {
+          break;
+        }
+      }
+      else if (diff < 0)
+      {
+        return false;
+      }
+      else
+      {
+        position = _tail.load(std::memory_order_relaxed);
+      }
+    }
+
+    new(&cell->_storage) Type(std::forward<Value>(value_));
+    cell->_seq.store(position + 1, std::memory_order_release);
+
+    _notify();
+
+    return true;
+  }
+
+  template<typename Type>
+  template<typename Value>
+  auto Channel<Type>::send(Value&& value_) noexcept -> bool
+  {
+    while (try_send(std::forward<Value>(value_)) == false)
+    {
+      if (closed())
+      {
+        return false;
+      }
+
+      _nimata_impl::_pause();
+    }
+
+    return true;
+  }
+
+  template<typename Type>
+  auto Channel<Type>::try_recv(Type& value_) noexcept -> bool
+  {
+    return _pop([&value_](Type& item_){ value_ = std::move(item_); });
+  }
+
+  template<typename Type>
+  auto Channel<Type>::recv(Type& value_) noexcept -> bool
+  {
+    while (try_recv(value_) == false)
+    {
+      if (closed())
+      {
+        return try_recv(value_);
+      }
+
+      _nimata_impl::_pause();
+    }
+
+    return true;
+  }
+
+  template<typename Type>
+  void Channel<Type>::close() noexcept
+  {
+    _closed.store(true, std::memory_order_release);
+  }
+
+  template<typename Type>
+  auto Channel<Type>::closed() const noexcept -> bool
+  {
+    return _closed.load(std::memory_order_acquire);
+  }
+
+  template<typename Type>
+  template<typename Callable>
+  void Channel<Type>::receive(Pool& pool_, Callable&& callable_) noexcept
+  {
+    _receiver* const listener = new _receiver{&pool_, std::forward<Callable>(callable_)};
+
+    _receiver* expected = nullptr;
+    if _stz_impl_ABNORMAL(_listener.compare_exchange_strong(expected, listener) == false)
+    {
+      _stz_impl_DBG_LVL_1(_stz_impl_DEBUG_MESSAGE("channel already has a receiver.");)
+      delete listener;
+      return;
+    }
+
+    // values sent before the receiver was set
+    if (_available())
+    {
+      _notify();
+    }
+  }
+
+  template<typename Type>
+  auto Channel<Type>::size() const noexcept -> size_t
+  {
+    const size_t tail = _tail.load(std::memory_order_relaxed);
+    const size_t head = _head.load(std::memory_order_relaxed);
+
+    return tail > head ? tail - head : 0;
+  }
+
+  template<typename Type>
+  auto Channel<Type>::capacity() const noexcept -> size_t
+  {
+    return _capacity;
+  }
+
+  template<typename Type>
+  Channel<Type>::~Channel() noexcept
+  {
+    while (_drains.load(std::memory_order_acquire) != 0)
+    {
+      std::this_thread::sleep_for(std::chrono::nanoseconds(1));
+    }
+
+    while (_pop([](Type&){}))
+    {}
+
+    delete _listener.load(std::memory_order_relaxed);
+  }
+
+  template<typename Type>
+  template<typename Consumer>
+  auto Channel<Type>::_pop(Consumer&& consumer_) noexcept -> bool
+  {
+    size_t position = _head.load(std::memory_order_relaxed);
+    _cell* cell;
+    while (true)
+    {
+      cell = &_cells[position % _ring];
+      const size_t seq  = cell->_seq.load(std::memory_order_acquire);
+      const auto   diff = static_cast<std::ptrdiff_t>(seq - (position + 1));
+
+      if (diff == 0)
+      {
+        if (_head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+        {
+          break;
+        }
+      }
+      else if (diff < 0)
+      {
+        return false;
+      }
+      else
+      {
+        position = _head.load(std::memory_order_relaxed);
+      }
+    }
+
+    Type& item = *reinterpret_cast<Type*>(&cell->_storage);
+    consumer_(item);
+    item.~Type();
+    cell->_seq.store(position + _ring, std::memory_order_release);
+
+    return true;
+  }
+
+  template<typename Type>
+  auto Channel<Type>::_available() const noexcept -> bool
+  {
+    const size_t position = _head.load(std::memory_order_relaxed);
+
+    return _cells[position % _ring]._seq.load(std::memory_order_acquire) == position + 1;
+  }
+
+  template<typename Type>
+  void Channel<Type>::_notify() noexcept
+  {
+    _receiver* const listener = _listener.load(std::memory_order_acquire);
+
+    if (listener == nullptr)
+    {
+      return;
+    }
+
+    // pairs with the fence in '_drain' so that either the drain sees the value or this sees it stopped
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if ((_scheduled.load(std::memory_order_relaxed) == false) and (_scheduled.exchange(true) == false))
+    {
+      ++_drains;
+      listener->_pool->_enqueue([this, listener]{ _drain(listener); });
+    }
+  }
+
+  template<typename Type>
+  void Channel<Type>::_drain(_receiver* const listener_) noexcept
+  {
+    while (true)
+    {
+      while (_pop(listener_->_callable))
+      {}
+
+      _scheduled.store(false, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+
+      if ((_available() == false) or _scheduled.exchange(true))
+      {
+        break;
+      }
+    }
+
+    --_drains;
+  }
+//*///------------------------------------------------------------------------------------------------------------------
+  class Latch final
+  {
+  public:
+    // latch that opens once counted down 'count' times
+    inline explicit Latch(size_t count) noexcept;
+
+    Latch(const Latch&) = delete;
+    auto operator=(const Latch&) -> Latch& = delete;
+
+    // count down by 'n', waiters are released once the count reaches zero
+    inline void count_down(size_t n = 1) noexcept;
+
+    // whether the count reached zero
+    inline auto try_wait() const noexcept -> bool;
+
+    // block until the count reaches zero, a fiber is suspended instead
+    inline void wait() noexcept;
+
+  private:
+    std::atomic_size_t                  _count;
+# if defined(_stz_impl_FIBERS)
+    std::mutex                          _waiters_mtx;
+    std::vector<_nimata_impl::_fiber*>  _waiters; // suspended fibers
+# endif
+  };
+
+  Latch::Latch(const size_t count_) noexcept
+    : _count(count_)
+  {}
+
+  void Latch::count_down(const size_t n_) noexcept
+  {
+    if (_count.fetch_sub(n_, std::memory_order_acq_rel) != n_)
+    {
+      return;
+    }
+
+# if defined(_stz_impl_FIBERS)
+    std::vector<_nimata_impl::_fiber*> waiters;
+    {
+      std::lock_guard<std::mutex> lock{_waiters_mtx};
+      waiters.swap(_waiters);
+    }
+
+    for (_nimata_impl::_fiber* const fiber : waiters)
+    {
+      _nimata_impl::_fiber::_wake(fiber);
+    }
+# endif
+  }
+
+  auto Latch::try_wait() const noexcept -> bool
+  {
+    return _count.load(std::memory_order_acquire) == 0;
+  }
+
+  void Latch::wait() noexcept
+  {
+# if defined(_stz_impl_FIBERS)
+    // the fiber is only registered once switched out, the count is checked again under the lock
+    if (_nimata_impl::_fiber::_suspendable() and try_wait() == false)
+    {
+      _nimata_impl::_fiber* const fiber = _nimata_impl::_fiber::_current();
+
+      _nimata_impl::_fiber::_suspend([this, fiber]{
+        {
+          std::lock_guard<std::mutex> lock{_waiters_mtx};
+          if (try_wait() == false)
+          {
+            _waiters.push_back(fiber);
+            return;
+          }
+        }
+
+        _nimata_impl::_fiber::_wake(fiber);
+      });
+    }
+# endif
+
+    while (try_wait() == false)
+    {
+      std::this_thread::sleep_for(std::chrono::nanoseconds(1));
+    }
+  }
+//*///------------------------------------------------------------------------------------------------------------------
+# if defined(_stz_impl_REACTOR)
+  class Reactor final
+  {
+  public:
+    // complete operations onto 'pool', with io_uring if asked for and available, epoll otherwise
+    inline explicit Reactor(Pool& pool, Backend backend = io_uring) noexcept;
+
+    // read up to 'size' bytes of 'fd' into 'buffer', at 'offset' or at the current position if negative
+    inline auto read(int fd, void* buffer, size_t size, off_t offset = -1) noexcept -> Future<ssize_t>;
+
+    // write up to 'size' bytes of 'buffer' to 'fd', at 'offset' or at the current position if negative
+    inline auto write(int fd, const void* buffer, size_t size, off_t offset = -1) noexcept -> Future<ssize_t>;
+
+    // accept a connection on the listening socket 'fd'
+    inline auto accept(int fd) noexcept -> Future<int>;
+
+    // same as above, 'callable(result)' is pushed to the pool upon completion
+    template<typename Callable>
+    void read(int fd, void* buffer, size_t size, off_t offset, Callable&& callable) noexcept;
+
+    template<typename Callable>
+    void write(int fd, const void* buffer, size_t size, off_t offset, Callable&& callable) noexcept;
+
+    template<typename Callable>
+    void accept(int fd, Callable&& callable) noexcept;
+
+    // get the backend in use
+    inline auto backend() const noexcept -> Backend;
+
+    // cancel pending operations, which complete with -ECANCELED, the pool must outlive the reactor
+    inline ~Reactor() noexcept;
+
+  private:
+    enum class _kind : uint_fast8_t
+    {
+      stop,
+      cancel,
+      read,
+      write,
+      accept
+    };
+    struct _operation final
+    {
+      _kind                        _type;
+      int                          _fd;
+      void*                        _buffer;
+      size_t                       _size;
+      off_t                        _offset;
+      std::function<void(ssize_t)> _done;
+    };
+    struct _interest final
+    {
+      std::deque<_operation*> _in;
+      std::deque<_operation*> _out;
+    };
+    template<typename Type>
+    auto _future(_kind type, int fd, void* buffer, size_t size, off_t offset) noexcept -> Future<Type>;
+    inline void _submit(_operation* operation) noexcept;
+    inline void _complete(_operation* operation, ssize_t result) noexcept;
+    inline static auto _perform(const _operation* operation) noexcept -> ssize_t;
+    inline void _epoll_submit(_operation* operation) noexcept;
+    inline auto _epoll_arm(int fd, const _interest& interest, bool fresh) noexcept -> int;
+    inline void _epoll_ready(int fd, uint32_t events) noexcept;
+    inline void _epoll_loop() noexcept;
+#   if defined(_stz_impl_IO_URING)
+    inline auto _uring_setup() noexcept -> bool;
+    inline void _uring_push(_kind type, int fd, uint64_t data, void* buffer, size_t size, off_t offset) noexcept;
+    inline void _uring_loop() noexcept;
+#   endif
+    Pool* const                              _pool;
+    Backend                                  _backend;
+    std::mutex                               _mtx;
+    std::unordered_map<int, _interest>       _interests;
+    std::unordered_set<_operation*>          _pending;
+    int                                      _epoll    = -1;
+    int                                      _wake     = -1;
+#   if defined(_stz_impl_IO_URING)
+    int                                      _ring     = -1;
+    io_uring_params                          _params;
+    void*                                    _sq_map   = nullptr;
+    size_t                                   _sq_bytes = 0;
+    void*                                    _cq_map   = nullptr;
+    size_t                                   _cq_bytes = 0;
+    io_uring_sqe*                            _sqes     = nullptr;
+#   endif
+    std::thread                              _reactor_thread;
+  };
+
+  Reactor::Reactor(Pool& pool_, const Backend backend_) noexcept :
+    _pool(&pool_),
+    _backend(epoll)
+  {
+#   if defined(_stz_impl_IO_URING)
+    if ((backend_ == io_uring) and _uring_setup())
+    {
+      _backend        = io_uring;
+      _reactor_thread = std::thread(&Reactor::_uring_loop, this);
+      return;
+    }
+#   else
+    (void)backend_;
+#   endif
+
+    _epoll = epoll_create1(EPOLL_CLOEXEC);
+    _wake  = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+
+    epoll_event event = {};
+    event.events  = EPOLLIN;
+    event.data.fd = _wake;
+    epoll_ctl(_epoll, EPOLL_CTL_ADD, _wake, &event);
+
+    _reactor_thread = std::thread(&Reactor::_epoll_loop, this);
+  }
+
+  auto Reactor::read(const int fd_, void* const buffer_, const size_t size_, const off_t offset_) noexcept
+    -> Future<ssize_t>
+  {
+    return _future<ssize_t>(_kind::read, fd_, buffer_, size_, offset_);
+  }
+
+  auto Reactor::write(const int fd_, const void* const buffer_, const size_t size_, const off_t offset_) noexcept
+    -> Future<ssize_t>
+  {
+    return _future<ssize_t>(_kind::write, fd_, const_cast<void*>(buffer_), size_, offset_);
+  }
+
+  auto Reactor::accept(const int fd_) noexcept -> Future<int>
+  {
+    return _future<int>(_kind::accept, fd_, nullptr, 0, -1);
+  }
+
+  template<typename Callable>
+  void Reactor::read(const int fd_, void* const buffer_, const size_t size_, const off_t offset_, Callable&& callable_) noexcept
+  {
+    _submit(new _operation{_kind::read, fd_, buffer_, size_, offset_, std::forward<Callable>(callable_)});
+  }
+
+  template<typename Callable>
+  void Reactor::write(const int fd_, const void* const buffer_, const size_t size_, const off_t offset_, Callable&& callable_) noexcept
+  {
+    _submit(new _operation{_kind::write, fd_, const_cast<void*>(buffer_), size_, offset_, std::forward<Callable>(callable_)});
+  }
+
+  template<typename Callable>
+  void Reactor::accept(const int fd_, Callable&& callable_) noexcept
+  {
+    _submit(new _operation{_kind::accept, fd_, nullptr, 0, -1, std::forward<Callable>(callable_)});
+  }
+
+  auto Reactor::backend() const noexcept -> Backend
+  {
+    return _backend;
+  }
+
+  Reactor::~Reactor() noexcept
+  {
+#   if defined(_stz_impl_IO_URING)
+    // the reactor thread stops once the cancellations completed every pending operation
+    if (_backend == io_uring)
+    {
+      std::lock_guard<std::mutex> lock(_mtx);
+
+      for (_operation* const operation : _pending)
+      {
+        _uring_push(_kind::cancel, -1, 1, operation, 0, 0);
+      }
+
+      _uring_push(_kind::stop, -1, 0, nullptr, 0, 0);
+    }
+    else
+#   endif
+    {
+      const uint64_t one = 1;
+      ssize_t written;
+      do
+      {
+        written = ::write(_wake, &one, sizeof(one));
+      } while ((written < 0) and (errno == EINTR));
+    }
+
+    _reactor_thread.join();
+
+#   if defined(_stz_impl_IO_URING)
+    if (_backend == io_uring)
+    {
+      munmap(_sqes, _params.sq_entries * sizeof(io_uring_sqe));
+      if (_cq_map != _sq_map)
+      {
+        munmap(_cq_map, _cq_bytes);
+      }
+      munmap(_sq_map, _sq_bytes);
+      close(_ring);
+      return;
+    }
+#   endif
+
+    close(_wake);
+    close(_epoll);
+  }
+
+  template<typename Type>
+  auto Reactor::_future(const _kind type_, const int fd_, void* const buffer_, const size_t size_, const off_t offset_) noexcept
+    -> Future<Type>
+  {
+    _nimata_impl::_state<Type>* const state = new _nimata_impl::_state<Type>;
+    Future<Type> future(state);
+
+    _submit(new _operation{type_, fd_, buffer_, size_, offset_, [state](const ssize_t result_)
+    {
+      state->_set(static_cast<Type>(result_));
+      state->_release();
+    }});
+
+    return future;
+  }
+
+  void Reactor::_submit(_operation* const operation_) noexcept
+  {
+#   if defined(_stz_impl_IO_URING)
+    if (_backend == io_uring)
+    {
+      std::lock_guard<std::mutex> lock(_mtx);
+      _pending.insert(operation_);
+      _uring_push(operation_->_type, operation_->_fd, reinterpret_cast<uintptr_t>(operation_),
+        operation_->_buffer, operation_->_size, operation_->_offset);
+      return;
+    }
+#   endif
+
+    _epoll_submit(operation_);
+  }
+
+  void Reactor::_complete(_operation* const operation_, const ssize_t result_) noexcept
+  {
+    _pool->_enqueue([operation_, result_]
+    {
+      operation_->_done(result_);
+      delete operation_;
+    });
+  }
+
+  auto Reactor::_perform(const _operation* const operation_) noexcept -> ssize_t
+  {
+    ssize_t result = -1;
+
+    do
+    {
+      switch (operation_->_type)
+      {
+        case _kind::read:
+          if (operation_->_offset >= 0)
+          {
+            result = pread(operation_->_fd, operation_->_buffer, operation_->_size, operation_->_offset);
+          }
+          else
+          {
+            result = recv(operation_->_fd, operation_->_buffer, operation_->_size, MSG_DONTWAIT);
+            if ((result < 0) and (errno == ENOTSOCK))
+            {
+              result = ::read(operation_->_fd, operation_->_buffer, operation_->_size);
+            }
+          }
+          break;
+
+        case _kind::write:
+          if (operation_->_offset >= 0)
+          {
+            result = pwrite(operation_->_fd, operation_->_buffer, operation_->_size, operation_->_offset);
+          }
+          else
+          {
+            result = send(operation_->_fd, operation_->_buffer, operation_->_size, MSG_DONTWAIT | MSG_NOSIGNAL);
+            if ((result < 0) and (errno == ENOTSOCK))
+            {
+              result = ::write(operation_->_fd, operation_->_buffer, operation_->_size);
+            }
+          }
+          break;
+
+        case _kind::accept:
+          result = ::accept(operation_->_fd, nullptr, nullptr);
+          break;
+
+        case _kind::stop:
+        case _kind::cancel:
+        default:
+          result = 0;
+      }
+    } while ((result < 0) and (errno == EINTR));
+
+    return result < 0 ? -errno : result;
+  }
+
+  void Reactor::_epoll_submit(_operation* const operation_) noexcept
+  {
+    std::unique_lock<std::mutex> lock(_mtx);
+
+    _interest&       interest = _interests[operation_->_fd];
+    const bool       fresh    = interest._in.empty() and interest._out.empty();
+    const bool       inbound  = (operation_->_type != _kind::write);
+
+    (inbound ? interest._in : interest._out).push_back(operation_);
+
+    const int error = _epoll_arm(operation_->_fd, interest, fresh);
+    if _stz_impl_EXPECTED(error == 0)
+    {
+      return;
+    }
+
+    (inbound ? interest._in : interest._out).pop_back();
+    if (fresh)
+    {
+      _interests.erase(operation_->_fd);
+    }
+    lock.unlock();
+
+    if (error == EPERM)
+    {
+      // regular files are always ready and cannot be polled, the operation is performed by a worker instead
+      _pool->_enqueue([operation_]
+      {
+        operation_->_done(_perform(operation_));
+        delete operation_;
+      });
+    }
+    else
+    {
+      _complete(operation_, -error);
+    }
+  }
+
+  auto Reactor::_epoll_arm(const int fd_, const _interest& interest_, const bool fresh_) noexcept -> int
+  {
+    epoll_event event = {};
+    event.events  = EPOLLONESHOT;
+    event.events |= interest_._in.empty()  ? 0u : static_cast<uint32_t>(EPOLLIN);
+    event.events |= interest_._out.empty() ? 0u : static_cast<uint32_t>(EPOLLOUT);
+    event.data.fd = fd_;
+
+    if (epoll_ctl(_epoll, fresh_ ? EPOLL_CTL_ADD : EPOLL_CTL_MOD, fd_, &event) == 0)
+    {
+      return 0;
+    }
+
+    return errno;
+  }
+
+  void Reactor::_epoll_ready(const int fd_, const uint32_t events_) noexcept
+  {
+    std::lock_guard<std::mutex> lock(_mtx);
+
+    const auto found = _interests.find(fd_);
+    if _stz_impl_ABNORMAL(found == _interests.end())
+    {
+      return;
+    }
+
+    _interest& interest = found->second;
+
+    // a blocking descriptor is made non-blocking meanwhile, so no read, write or accept can stall the reactor thread
+    const int  flags    = fcntl(fd_, F_GETFL);
+    const bool blocking = (flags >= 0) and ((flags & O_NONBLOCK) == 0);
+    if (blocking)
+    {
+      fcntl(fd_, F_SETFL, flags | O_NONBLOCK);
+    }
+
+    // operations are retried in submission order until one would block
+    const uint32_t failure = EPOLLERR | EPOLLHUP;
+    if (events_ & (EPOLLIN | failure))
+    {
+      while (interest._in.empty() == false)
+      {
+        const ssize_t result = _perform(interest._in.front());
+        if (result == -EAGAIN)
+        {
+          break;
+        }
+
+        _complete(interest._in.front(), result);
+        interest._in.pop_front();
+      }
+    }
+
+    if (events_ & (EPOLLOUT | failure))
+    {
+      while (interest._out.empty() == false)
+      {
+        const ssize_t result = _perform(interest._out.front());
+        if (result == -EAGAIN)
+        {
+          break;
+        }
+
+        _complete(interest._out.front(), result);
+        interest._out.pop_front();
+      }
+    }
+
+    if (blocking)
+    {
+      fcntl(fd_, F_SETFL, flags);
+    }
+
+    if (interest._in.empty() and interest._out.empty())
+    {
+      epoll_ctl(_epoll, EPOLL_CTL_DEL, fd_, nullptr);
+      _interests.erase(found);
+    }
+    else
+    {
+      _epoll_arm(fd_, interest, false);
+    }
+  }
+
+  void Reactor::_epoll_loop() noexcept
+  {
+    epoll_event events[64];
+
+    while (true)
+    {
+      const int count = epoll_wait(_epoll, events, 64, -1);
+
+      bool stop = false;
+      for (int k = 0; k < count; ++k)
+      {
+        if (events[k].data.fd == _wake)
+        {
+          stop = true;
+        }
+        else
+        {
+          _epoll_ready(events[k].data.fd, events[k].events);
+        }
+      }
+
+      if (stop)
+      {
+        break;
+      }
+    }
+
+    std::lock_guard<std::mutex> lock(_mtx);
+    for (auto& entry : _interests)
+    {
+      for (_operation* const operation : entry.second._in)
+      {
+        _complete(operation, -ECANCELED);
+      }
+
+      for (_operation* const operation : entry.second._out)
+      {
+        _complete(operation, -ECANCELED);
+      }
+
+      epoll_ctl(_epoll, EPOLL_CTL_DEL, entry.first, nullptr);
+    }
+    _interests.clear();
+  }
+
+#   if defined(_stz_impl_IO_URING)
+  auto Reactor::_uring_setup() noexcept -> bool
+  {
+    _params = io_uring_params();
+
+    const long ring = syscall(__NR_io_uring_setup, 256, &_params);
+    if ((ring < 0) or ((_params.features & IORING_FEAT_RW_CUR_POS) == 0))
+    {
+      if (ring >= 0)
+      {
+        close(static_cast<int>(ring));
+      }
+
+      _stz_impl_DBG_LVL_1(_stz_impl_DEBUG_MESSAGE("io_uring unavailable, epoll used instead.");)
+      return false;
+    }
+    _ring = static_cast<int>(ring);
+
+    _sq_bytes = _params.sq_off.array + _params.sq_entries * sizeof(unsigned);
+    _cq_bytes = _params.cq_off.cqes  + _params.cq_entries * sizeof(io_uring_cqe);
+
+    if (_params.features & IORING_FEAT_SINGLE_MMAP)
+    {
+      _sq_bytes = _cq_bytes = std::max(_sq_bytes, _cq_bytes);
+    }
+
+    _sq_map = mmap(nullptr, _sq_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring, IORING_OFF_SQ_RING);
+    _cq_map = (_params.features & IORING_FEAT_SINGLE_MMAP) ? _sq_map :
+      mmap(nullptr, _cq_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring, IORING_OFF_CQ_RING);
+    void* const sqes = mmap(nullptr, _params.sq_entries * sizeof(io_uring_sqe),
+      PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring, IORING_OFF_SQES);
+
+    if ((_sq_map == MAP_FAILED) or (_cq_map == MAP_FAILED) or (sqes == MAP_FAILED))
+    {
+      if (sqes != MAP_FAILED)
+      {
+        munmap(sqes, _params.sq_entries * sizeof(io_uring_sqe));
+      }
+      if ((_cq_map != MAP_FAILED) and (_cq_map != _sq_map))
+      {
+        munmap(_cq_map, _cq_bytes);
+      }
+      if (_sq_map != MAP_FAILED)
+      {
+        munmap(_sq_map, _sq_bytes);
+      }
+      close(_ring);
+      return false;
+    }
+
+    _sqes = static_cast<io_uring_sqe*>(sqes);
+
+    return true;
+  }
+
+  // '_mtx' must be held, a cancellation's 'buffer' is the operation to cancel
+  void Reactor::_uring_push(const _kind type_, const int fd_, const uint64_t data_, void* const buffer_,
+    const size_t size_, const off_t offset_) noexcept
+  {
+    char* const      sq    = static_cast<char*>(_sq_map);
+    unsigned* const  tail  = reinterpret_cast<unsigned*>(sq + _params.sq_off.tail);
+    unsigned* const  array = reinterpret_cast<unsigned*>(sq + _params.sq_off.array);
+    const unsigned   mask  = *reinterpret_cast<unsigned*>(sq + _params.sq_off.ring_mask);
+
+    const unsigned index = *tail & mask;
+    io_uring_sqe&  sqe   = _sqes[index];
+    sqe = io_uring_sqe();
+
+    sqe.fd        = fd_;
+    sqe.user_data = data_;
+    switch (type_)
+    {
+      case _kind::read:
+        sqe.opcode = IORING_OP_READ;
+        sqe.addr   = reinterpret_cast<uintptr_t>(buffer_);
+        sqe.len    = static_cast<uint32_t>(size_);
+        sqe.off    = static_cast<uint64_t>(offset_);
+        break;
+
+      case _kind::write:
+        sqe.opcode = IORING_OP_WRITE;
+        sqe.addr   = reinterpret_cast<uintptr_t>(buffer_);
+        sqe.len    = static_cast<uint32_t>(size_);
+        sqe.off    = static_cast<uint64_t>(offset_);
+        break;
+
+      case _kind::accept:
+        sqe.opcode = IORING_OP_ACCEPT;
+        break;
+
+      case _kind::cancel:
+        sqe.opcode = IORING_OP_ASYNC_CANCEL;
+        sqe.addr   = reinterpret_cast<uintptr_t>(buffer_);
+        break;
+
+      case _kind::stop:
+      default:
+        sqe.opcode = IORING_OP_NOP;
+    }
+
+    array[index] = index;
+    __atomic_store_n(tail, *tail + 1, __ATOMIC_RELEASE);
+
+    while ((syscall(__NR_io_uring_enter, _ring, 1, 0, 0, nullptr, 0) < 0) and ((errno == EINTR) or (errno == EAGAIN)))
+    {}
+  }
+
+  void Reactor::_uring_loop() noexcept
+  {
+    char* const         cq   = static_cast<char*>(_cq_map);
+    unsigned* const     head = reinterpret_cast<unsigned*>(cq + _params.cq_off.head);
+    unsigned* const     tail = reinterpret_cast<unsigned*>(cq + _params.cq_off.tail);
+    const unsigned      mask = *reinterpret_cast<unsigned*>(cq + _params.cq_off.ring_mask);
+    io_uring_cqe* const cqes = reinterpret_cast<io_uring_cqe*>(cq + _params.cq_off.cqes);
+
+    bool stop = false;
+    while (true)
+    {
+      unsigned       current = *head;
+      const unsigned last    = __atomic_load_n(tail, __ATOMIC_ACQUIRE);
+
+      if (current == last)
+      {
+        {
+          std::lock_guard<std::mutex> lock(_mtx);
+          if (stop and _pending.empty())
+          {
+            break;
+          }
+        }
+
+        syscall(__NR_io_uring_enter, _ring, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+        continue;
+      }
+
+      for (; current != last; ++current)
+      {
+        const io_uring_cqe& cqe = cqes[current & mask];
+
+        // user data is 0 for the stop request, 1 for cancellations and the operation otherwise
+        if (cqe.user_data == 0)
+        {
+          stop = true;
+        }
+        else if (cqe.user_data != 1)
+        {
+          _operation* const operation = reinterpret_cast<_operation*>(static_cast<uintptr_t>(cqe.user_data));
+          {
+            std::lock_guard<std::mutex> lock(_mtx);
+            _pending.erase(operation);
+          }
+          _complete(operation, cqe.res);
+        }
+      }
+
+      __atomic_store_n(head, current, __ATOMIC_RELEASE);
+    }
+  }
+#   endif
+# endif
+//*///------------------------------------------------------------------------------------------------------------------
+# if defined(_stz_impl_SHARED)
+  class SharedQueue final
+  {
+  public:
+    // open the queue named 'name', creating it with room for 'capacity' payloads of up to 'payload' bytes if needed,
+    // an anonymous queue is created if 'name' is null, other processes then open it through 'fd'
+    inline explicit SharedQueue(const char* name = nullptr, size_t capacity = 1024, size_t payload = 256) noexcept;
+
+    // open the queue mapped by 'fd', as inherited from the process that created it
+    inline explicit SharedQueue(int fd) noexcept;
+
+    SharedQueue(const SharedQueue&) = delete;
+    auto operator=(const SharedQueue&) -> SharedQueue& = delete;
+
+    // whether the queue is mapped
+    inline auto valid() const noexcept -> bool;
+
+    // get the descriptor of the mapping
+    inline auto fd() const noexcept -> int;
+
+    // remove the name 'name', processes that opened the queue keep it mapped
+    inline static auto unlink(const char* name) noexcept -> bool;
+
+    // run 'callable(data, size)' for every payload posted with 'kind', handlers are set before consuming
+    template<typename Callable>
+    void handle(uint32_t kind, Callable&& callable) noexcept;
+
+    // post 'size' bytes of 'data' with 'kind' if there is room, false if full or larger than a payload
+    inline auto try_post(uint32_t kind, const void* data, size_t size) noexcept -> bool;
+
+    // post 'size' bytes of 'data' with 'kind' once there is room, false if larger than a payload
+    inline auto post(uint32_t kind, const void* data, size_t size) noexcept -> bool;
+
+    // post the bytes of 'value', which must be trivially copyable
+    template<typename Type>
+    auto post(uint32_t kind, const Type& value) noexcept -> bool;
+
+    // take payloads only while 'pool' has idle workers and push their handlers to it, at most once per queue
+    inline void consume(Pool& pool) noexcept;
+
+    // get approximate amount of payloads held
+    inline auto size() const noexcept -> size_t;
+
+    // get maximum amount of payloads held
+    inline auto capacity() const noexcept -> size_t;
+
+    // get maximum size of a payload
+    inline auto payload() const noexcept -> size_t;
+
+    // get the amount of payloads lost with processes that died while posting or taking them
+    inline auto lost() const noexcept -> size_t;
 
-    template<typename Type>
-    using _if_iterable = typename std::enable_if<_is_iterable<Type>::value>::type;
+    // stop consuming, wait for the handlers already pushed then unmap the queue, the pool must outlive the queue
+    inline ~SharedQueue() noexcept;
 
-    template<typename Type>
-    auto _begin(Type&& iterable_) noexcept -> typename std::enable_if<
-      _has_iter_meths<Type>::value and not _has_iter_funcs<Type>::value,
-      decltype(std::declval<Type&>().begin())
-    >::type
+  private:
+    static_assert(ATOMIC_INT_LOCK_FREE == 2 and (sizeof(long) == 8 ? ATOMIC_LONG_LOCK_FREE : ATOMIC_LLONG_LOCK_FREE) == 2,
+      "nimata: atomics shared between processes must be lock-free.");
+    static constexpr uint32_t _magic = 0x4E494D51;
+    enum _role : uint32_t
     {
-      return iterable_.begin();
-    }
+      _posting = 0,
+      _taking  = 1
+    };
+    struct _layout final
+    {
+      std::atomic<uint32_t> _ready;     // '_magic' once the cells are initialized
+      uint32_t              _capacity;
+      uint32_t              _ring;      // cells, at least 2 so that a full cell and a free one never share a sequence
+      uint32_t              _payload;
+      uint32_t              _stride;    // bytes from a cell to the next
+      char                  _padding_0[_nimata_impl::_cache_line - 5 * sizeof(uint32_t)];
+      std::atomic<uint64_t> _tail;
+      char                  _padding_1[_nimata_impl::_cache_line - sizeof(std::atomic<uint64_t>)];
+      std::atomic<uint64_t> _head;
+      char                  _padding_2[_nimata_impl::_cache_line - sizeof(std::atomic<uint64_t>)];
+      std::atomic<uint32_t> _posted;    // futex word bumped after each post
+      std::atomic<uint32_t> _taken;     // futex word bumped after each take
+      std::atomic<uint32_t> _consumers; // consumers waiting on '_posted'
+      std::atomic<uint32_t> _producers; // producers waiting on '_taken'
+      std::atomic<uint32_t> _lost;      // payloads lost with processes that died while holding them
+      char                  _padding_3[_nimata_impl::_cache_line - 5 * sizeof(std::atomic<uint32_t>)];
+    };
+    struct _cell final
+    {
+      std::atomic<uint64_t> _seq;
+      std::atomic<uint64_t> _owner; // stamp of the process holding the cell, see '_stamp'
+      uint32_t              _kind;
+      uint32_t              _size;
+      // payload follows
+    };
+    struct _delivery final
+    {
+      SharedQueue*       _queue;
+      const std::function<void(const void*, size_t)>* _handler;
+      std::vector<char>  _data;
+      inline void operator()() noexcept;
+    };
+    inline void _create(size_t capacity, size_t payload) noexcept;
+    inline void _open() noexcept;
+    inline auto _at(uint64_t position) const noexcept -> _cell*;
+    inline auto _take(uint32_t& kind, std::vector<char>& data) noexcept -> bool;
+    inline auto _reclaim(_cell* cell, uint64_t position) noexcept -> bool;
+    inline void _released() noexcept;
+    inline static auto _stamp(uint64_t position, _role role, uint32_t pid) noexcept -> uint64_t;
+    inline static auto _stamped(uint64_t owner, uint64_t position, _role role) noexcept -> bool;
+    inline static auto _died(uint64_t owner) noexcept -> bool;
+    inline void _consume() noexcept;
+    inline static void _wait(std::atomic<uint32_t>& word, uint32_t expected) noexcept;
+    inline static void _wake(std::atomic<uint32_t>& word, int count) noexcept;
+    int                                                                     _fd         = -1;
+    size_t                                                                  _bytes      = 0;
+    _layout*                                                                _shared     = nullptr;
+    char*                                                                   _cells      = nullptr;
+    std::unordered_map<uint32_t, std::function<void(const void*, size_t)>> _handlers;
+    Pool*                                                                   _pool       = nullptr;
+    std::atomic_bool                                                        _consuming  = {false};
+    std::atomic_uint                                                        _delivering = {0};
+    std::thread                                                             _consumer;
+  };
 
-    template<typename Type>
-    auto _begin(Type&& iterable_) noexcept -> typename std::enable_if<
-      _has_iter_funcs<Type>::value,
-      decltype(begin(std::declval<Type&>()))
-    >::type
+  SharedQueue::SharedQueue(const char* const name_, const size_t capacity_, const size_t payload_) noexcept
+  {
+    if (name_ == nullptr)
     {
-      return begin(std::forward<Type>(iterable_));
+      _fd = memfd_create("nimata", 0);
+      if (_fd >= 0)
+      {
+        _create(capacity_, payload_);
+      }
+      return;
     }
 
-    template<typename Type>
-    auto _end(Type&& iterable_) noexcept -> typename std::enable_if<
-      _has_iter_meths<Type>::value and not _has_iter_funcs<Type>::value,
-      decltype(std::declval<Type&>().end())
-    >::type
+    // only the process that creates the name initializes the queue
+    _fd = shm_open(name_, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (_fd >= 0)
     {
-      return iterable_.end();
+      _create(capacity_, payload_);
+      return;
     }
 
-    template<typename Type>
-    auto _end(Type&& iterable_) noexcept -> typename std::enable_if<
-      _has_iter_funcs<Type>::value,
-      decltype(end(std::declval<Type&>()))
-    >::type
+    if (errno == EEXIST)
     {
-      return end(std::forward<Type>(iterable_));
+      _fd = shm_open(name_, O_RDWR, 0600);
+      if (_fd >= 0)
+      {
+        _open();
+      }
     }
+  }
 
-    template<typename Type>
-    auto _begin(Type* pointer_) noexcept -> Type*
+  SharedQueue::SharedQueue(const int fd_) noexcept :
+    _fd(dup(fd_))
+  {
+    if (_fd >= 0)
     {
-      return pointer_;
+      _open();
     }
+  }
 
-    template<typename Type>
-    auto _end(Type* pointer_) noexcept -> Type*
+  auto SharedQueue::valid() const noexcept -> bool
+  {
+    return _shared != nullptr;
+  }
+
+  auto SharedQueue::fd() const noexcept -> int
+  {
+    return _fd;
+  }
+
+  auto SharedQueue::unlink(const char* const name_) noexcept -> bool
+  {
+    return shm_unlink(name_) == 0;
+  }
+
+  template<typename Callable>
+  void SharedQueue::handle(const uint32_t kind_, Callable&& callable_) noexcept
+  {
+    _handlers[kind_] = std::forward<Callable>(callable_);
+  }
+
+  auto SharedQueue::try_post(const uint32_t kind_, const void* const data_, const size_t size_) noexcept -> bool
+  {
+    if _stz_impl_ABNORMAL(_shared == nullptr or size_ > _shared->_payload)
     {
-      return pointer_;
+      return false;
     }
 
-    template<typename Type, bool = _is_iterable<Type>::value>
-    struct _iter_type;
+    const uint64_t ring = _shared->_ring;
+    const uint32_t self = static_cast<uint32_t>(getpid());
 
-    template<typename Type>
-    struct _iter_type<Type, true> final
+    // same turns as in 'Channel': a cell's sequence is 'position' to post, 'position + 1' to take,
+    // a cell is stamped by whoever holds it before claiming it, so that a holder that died can be taken over
+    uint64_t position = _shared->_tail.load(std::memory_order_relaxed);
+    _cell* cell;
+    while (true)
     {
-      using iter = decltype( _begin(std::declval<Type&>()));
-      using type = decltype(*_begin(std::declval<Type&>()));
+      cell = _at(position);
+      const uint64_t seq  = cell->_seq.load(std::memory_order_acquire);
+      const auto     diff = static_cast<int64_t>(seq - position);
 
-      static
-      type _deref(iter& data) noexcept
+      if (diff == 0)
       {
-        return *data;
-      }
+        // a ring larger than the capacity only has room while fewer than 'capacity' payloads are held
+        if (_shared->_ring != _shared->_capacity)
+        {
+          const uint64_t head = _shared->_head.load(std::memory_order_acquire);
+          if (head > position)
+          {
+            position = _shared->_tail.load(std::memory_order_relaxed);
+            continue;
+          }
 
-      static
-      const type _deref(const iter& data) noexcept
-      {
-        return *data;
-      }
-    };
+          if (position - head >= _shared->_capacity)
+          {
+            return false;
+          }
+        }
 
-    template<typename Type>
-    struct _iter_type<Type, false> final
-    {
-      using iter = Type;
-      using type = Type;
+        // the cell was released by a consumer, or is claimed by a producer that died
+        uint64_t owner = cell->_owner.load(std::memory_order_acquire);
+        if (_stamped(owner, position - ring, _taking) or (_stamped(owner, position, _posting) and _died(owner)))
+        {
+          if (cell->_owner.compare_exchange_strong(owner, _stamp(position, _posting, self), std::memory_order_acq_rel)
+            and cell->_seq.load(std::memory_order_acquire) == position)
+          {
+            // fails only if the producer that died had claimed the position, which is now ours
+            uint64_t expected = position;
+            _shared->_tail.compare_exchange_strong(expected, position + 1, std::memory_order_relaxed);
+            break;
+          }
+        }
 
-      static
-      type _deref(const iter data) noexcept
+        position = _shared->_tail.load(std::memory_order_relaxed);
+      }
+      else if (diff < 0)
       {
-        return data;
+        // full, unless the consumer of the previous lap died before releasing the cell
+        if (_reclaim(cell, position - ring) == false)
+        {
+          return false;
+        }
       }
-    };
+      else
+      {
+        position = _shared->_tail.load(std::memory_order_relaxed);
+      }
+    }
 
-    template<typename Callable, typename... Arguments>
-    using _result = decltype(std::declval<Callable&>()(std::declval<Arguments&>()...));
+    cell->_kind = kind_;
+    cell->_size = static_cast<uint32_t>(size_);
+    if (size_ != 0)
+    {
+      std::copy_n(static_cast<const char*>(data_), size_, reinterpret_cast<char*>(cell + 1));
+    }
+    cell->_seq.store(position + 1, std::memory_order_release);
 
-    template<typename Callable, typename... Arguments>
-    using _auto = typename std::conditional<
-      std::is_same<_result<Callable, Arguments...>, void>::value,
-      void,
-      std::future<_result<Callable, Arguments...>>
-    >::type;
+    _shared->_posted.fetch_add(1);
+    if (_shared->_consumers.load() != 0)
+    {
+      _wake(_shared->_posted, 1);
+    }
 
-    template<typename Callable, typename... Arguments>
-    using _future = typename std::future<_result<Callable, Arguments...>>;
+    return true;
+  }
 
-    template<Tracking tracking, typename Callable, typename... Arguments>
-    using _tracking = 
-      typename std::conditional<tracking == Tracking::stray,
-        void,
-        typename std::conditional<tracking == Tracking::bound,
-          std::future<_result<Callable, Arguments...>>,
-          typename std::conditional<std::is_same<_result<Callable, Arguments...>, void>::value,
-            void,
-            std::future<_result<Callable, Arguments...>>
-          >::type
-        >::type
-      >::type;
+  auto SharedQueue::post(const uint32_t kind_, const void* const data_, const size_t size_) noexcept -> bool
+  {
+    if _stz_impl_ABNORMAL(_shared == nullptr or size_ > _shared->_payload)
+    {
+      return false;
+    }
 
-    using _attached = std::integral_constant<Tracking, Tracking::bound>;
-    using _detached = std::integral_constant<Tracking, Tracking::stray>;
-    using _inferred = std::integral_constant<Tracking, Tracking::infer>;
+    while (true)
+    {
+      // the word is read before trying, so that a take in between makes the wait return at once
+      const uint32_t taken = _shared->_taken.load();
+      if (try_post(kind_, data_, size_))
+      {
+        return true;
+      }
 
-    template<typename Type>
-    struct _parfor;
+      ++_shared->_producers;
+      _wait(_shared->_taken, taken);
+      --_shared->_producers;
+    }
+  }
 
-    template<typename Result>
-    struct _push;
+  template<typename Type>
+  auto SharedQueue::post(const uint32_t kind_, const Type& value_) noexcept -> bool
+  {
+    static_assert(std::is_trivially_copyable<Type>::value, "nimata: only trivially copyable values can be posted.");
+
+    return post(kind_, &value_, sizeof(Type));
   }
-//*///------------------------------------------------------------------------------------------------------------------
-  class Pool
+
+  void SharedQueue::consume(Pool& pool_) noexcept
   {
-  public:
-    // constructs pool
-    inline Pool(signed number_of_threads = max_threads) noexcept;
+    if _stz_impl_ABNORMAL(_shared == nullptr or _consuming.exchange(true))
+    {
+      _stz_impl_DBG_LVL_1(_stz_impl_DEBUG_MESSAGE("shared queue is invalid or already consumed.");)
+      return;
+    }
 
-    // add work and specify if you want it detached or not
-    template<Tracking tracking = Tracking::infer, typename Callable, typename... Arguments>
-    inline auto push
-    (
-      Callable&&     callable,
-      Arguments&&... arguments
-    ) noexcept -> _nimata_impl::_tracking<tracking, Callable, Arguments...>;
+    _pool     = &pool_;
+    _consumer = std::thread(&SharedQueue::_consume, this);
+  }
 
-    // waits for all work to be done
-    inline void wait() const noexcept;
+  auto SharedQueue::size() const noexcept -> size_t
+  {
+    if (_shared == nullptr)
+    {
+      return 0;
+    }
 
-    // enable workers
-    inline void work() noexcept;
+    const uint64_t head = _shared->_head.load(std::memory_order_relaxed);
+    const uint64_t tail = _shared->_tail.load(std::memory_order_relaxed);
 
-    // disable workers
-    inline void stop() noexcept;
+    return tail > head ? static_cast<size_t>(tail - head) : 0;
+  }
 
-    // parallel for-loop with index range = [0, 'size')
-    inline auto parfor(size_t size) noexcept -> _nimata_impl::_parfor<size_t>;
+  auto SharedQueue::capacity() const noexcept -> size_t
+  {
+    return _shared == nullptr ? 0 : _shared->_capacity;
+  }
 
-    // parallel for-loop with index range = ['from', 'past')
-    inline auto parfor(size_t from, size_t past) noexcept -> _nimata_impl::_parfor<size_t>;
+  auto SharedQueue::payload() const noexcept -> size_t
+  {
+    return _shared == nullptr ? 0 : _shared->_payload;
+  }
 
-    // parallel for-loop over iterable
-    template<typename Iterable, typename = _nimata_impl::_if_iterable<Iterable>>
-    inline auto parfor(Iterable&& thing) noexcept -> _nimata_impl::_parfor<Iterable>;
+  auto SharedQueue::lost() const noexcept -> size_t
+  {
+    return _shared == nullptr ? 0 : _shared->_lost.load(std::memory_order_relaxed);
+  }
 
-    // parallel for-loop over fixed-size array
-    template<typename Type, size_t Size>
-    auto parfor(Type (&array)[Size]) noexcept -> _nimata_impl::_parfor<Type*>;
+  SharedQueue::~SharedQueue() noexcept
+  {
+    if (_consumer.joinable())
+    {
+      _consuming = false;
+      _wake(_shared->_posted, INT_MAX);
+      _consumer.join();
+    }
 
-    // get amount of workers
-    inline auto size() const noexcept -> unsigned;
+    while (_delivering != 0)
+    {
+      std::this_thread::sleep_for(std::chrono::nanoseconds(1));
+    }
 
-    // set amount of workers
-    inline void size(signed number_of_threads) noexcept;
+    if (_shared != nullptr)
+    {
+      munmap(_shared, _bytes);
+    }
 
-    // waits for all work to be done then join threads
-    inline ~Pool() noexcept;
+    if (_fd >= 0)
+    {
+      close(_fd);
+    }
+  }
 
-  private:
-    template<typename> friend struct _nimata_impl::_parfor;
-    template<typename> friend struct _nimata_impl::_push;
-    inline void _assign() noexcept;
-    std::atomic_bool                    _alive  = {true};
-    std::atomic_bool                    _active = {true};
-    std::atomic_uint                    _size;
-    std::atomic<_nimata_impl::_worker*> _workers;
-    std::mutex                          _queue_mtx;
-    std::queue<std::function<void()>>   _queue;
-    std::thread                         _assignation_thread{_assign, this};
+  void SharedQueue::_delivery::operator()() noexcept
+  {
+    (*_handler)(_data.data(), _data.size());
+    --_queue->_delivering;
+  }
 
-    template<typename F, typename... A>
-    auto push(_nimata_impl::_detached, F&& function, A&&... arguments) noexcept -> void;
-    template<typename F, typename... A>
-    auto push(_nimata_impl::_attached, F&& function, A&&... arguments) noexcept -> _nimata_impl::_future<F, A...>;
-    template<typename F, typename... A>
-    auto push(_nimata_impl::_inferred, F&& function, A&&... arguments) noexcept -> _nimata_impl::_auto<F, A...>;
-  };
-//*///------------------------------------------------------------------------------------------------------------------
-  namespace _nimata_impl
+  void SharedQueue::_create(size_t capacity_, size_t payload_) noexcept
   {
-    template<typename Type>
-    struct _parfor final
-    {
-      using iterator = typename _iter_type<Type>::iter;
+    capacity_ = std::min<size_t>(std::max<size_t>(capacity_, 1), UINT32_MAX);
+    payload_  = std::min<size_t>(payload_, UINT32_MAX - _nimata_impl::_cache_line);
 
-      _parfor(Pool* const pool_, const iterator& from_, const iterator& past_) noexcept
-        : _pool(pool_)
-        , _from(from_)
-        , _past(past_)
-      {}
+    const size_t stride = (sizeof(_cell) + payload_ + _nimata_impl::_cache_line - 1)
+      / _nimata_impl::_cache_line * _nimata_impl::_cache_line;
 
-      template<typename Callable>
-      void operator=(Callable&& callable_) noexcept
-      {
-        {
-          std::lock_guard<std::mutex> pool_queue_lock(_pool->_queue_mtx);
+    const size_t ring = capacity_ == 1 ? 2 : capacity_;
 
-          for (iterator iter = std::move(_from); iter != _past; ++iter)
-          {
-            _pool->_queue.push([=]{ callable_(_iter_type<Type>::_deref(iter)); });
-          }
-        }
+    _bytes = sizeof(_layout) + ring * stride;
+    if _stz_impl_ABNORMAL(ftruncate(_fd, static_cast<off_t>(_bytes)) != 0)
+    {
+      return;
+    }
 
-        _pool->wait();
-      }
+    void* const mapping = mmap(nullptr, _bytes, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+    if _stz_impl_ABNORMAL(mapping == MAP_FAILED)
+    {
+      return;
+    }
 
-      Pool* const    _pool;
-      iterator       _from;
-      const iterator _past;
-    };
+    _shared = new(mapping) _layout;
+    _shared->_capacity = static_cast<uint32_t>(capacity_);
+    _shared->_ring     = static_cast<uint32_t>(ring);
+    _shared->_payload  = static_cast<uint32_t>(payload_);
+    _shared->_stride   = static_cast<uint32_t>(stride);
+    _shared->_tail.store(0, std::memory_order_relaxed);
+    _shared->_head.store(0, std::memory_order_relaxed);
+    _shared->_posted.store(0, std::memory_order_relaxed);
+    _shared->_taken.store(0, std::memory_order_relaxed);
+    _shared->_consumers.store(0, std::memory_order_relaxed);
+    _shared->_producers.store(0, std::memory_order_relaxed);
+    _shared->_lost.store(0, std::memory_order_relaxed);
+
+    _cells = reinterpret_cast<char*>(_shared + 1);
+    for (size_t k = 0; k < ring; ++k)
+    {
+      new(_cells + k * stride) _cell{{k}, {_stamp(k - ring, _taking, 0)}, 0, 0};
+    }
 
-    template<typename Result>
-    struct _infer;
+    _shared->_ready.store(_magic, std::memory_order_release);
+  }
 
-    template<>
-    struct _infer<void>
+  void SharedQueue::_open() noexcept
+  {
+    // the creator sizes the file before initializing it, the layout is only read once marked ready
+    struct stat status = {};
+    for (unsigned k = 0; fstat(_fd, &status) == 0 and status.st_size == 0 and k < 1000; ++k)
     {
-      template<typename Callable, typename... Arguments>
-      static
-      void _impl(Pool* const pool_, Callable&& callable_, Arguments&&... arguments_)
-      {
-        return pool_->push<Tracking::stray>(callable_, arguments_...);
-      }
-    };
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
 
-    template<typename Result>
-    struct _infer
+    if _stz_impl_ABNORMAL(static_cast<size_t>(status.st_size) < sizeof(_layout))
     {
-      template<typename Callable, typename... Arguments>
-      static
-      auto _impl(Pool* const pool_, Callable&& callable_, Arguments&&... arguments_) -> std::future<Result>
-      {
-        return pool_->push<Tracking::bound>(callable_, arguments_...);
-      }
-    };
+      return;
+    }
 
-    template<>
-    struct _push<void>
+    _bytes = static_cast<size_t>(status.st_size);
+    void* const mapping = mmap(nullptr, _bytes, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+    if _stz_impl_ABNORMAL(mapping == MAP_FAILED)
     {
-      template<typename Callable, typename... Arguments>
-      static
-      auto _impl(Pool* const pool_, Callable&& callable_, Arguments&&... arguments_) -> std::future<void>
-      {
-        std::future<void> future;
+      return;
+    }
 
-        if _stz_impl_EXPECTED(_nimata_impl::_validate_callable(callable_) == true)
-        {
-          auto promise = new std::promise<void>;
+    _layout* const shared = static_cast<_layout*>(mapping);
+    for (unsigned k = 0; shared->_ready.load(std::memory_order_acquire) != _magic; ++k)
+    {
+      if _stz_impl_ABNORMAL(k == 1000)
+      {
+        munmap(mapping, _bytes);
+        return;
+      }
 
-          std::lock_guard<std::mutex>{pool_->_queue_mtx}, pool_->_queue.push(
-            [=]{ callable_(arguments_...), std::unique_ptr<std::promise<void>>(promise)->set_value(); }
-          );
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
 
-          future = promise->get_future();
+    _shared = shared;
+    _cells  = reinterpret_cast<char*>(_shared + 1);
+  }
 
-          _stz_impl_DBG_LVL_2(_stz_impl_DEBUG_MESSAGE("pushed an attached task.");)
-        }
-        else
-        {
-          _stz_impl_DBG_LVL_2(_stz_impl_DEBUG_MESSAGE("null task pushed.");)
-        }
+  auto SharedQueue::_at(const uint64_t position_) const noexcept -> _cell*
+  {
+    return reinterpret_cast<_cell*>(_cells + (position_ % _shared->_ring) * _shared->_stride);
+  }
 
-        return future;
-      }
-    };
+  auto SharedQueue::_take(uint32_t& kind_, std::vector<char>& data_) noexcept -> bool
+  {
+    const uint64_t ring = _shared->_ring;
+    const uint32_t self = static_cast<uint32_t>(getpid());
 
-    template<typename ResultType>
-    struct _push
+    uint64_t position = _shared->_head.load(std::memory_order_relaxed);
+    _cell* cell;
+    while (true)
     {
-      template<typename Callable, typename... Arguments>
-      static
-      auto _impl(Pool* const pool_, Callable&& callable_, Arguments&&... arguments_) -> std::future<ResultType>
+      cell = _at(position);
+      const uint64_t seq    = cell->_seq.load(std::memory_order_acquire);
+      const auto     diff   = static_cast<int64_t>(seq - (position + 1));
+      const bool     posted = diff == 0;
+
+      // a posted cell, or a cell claimed by a producer that may have died before posting it
+      if (posted or (diff == -1 and _shared->_tail.load(std::memory_order_acquire) > position))
       {
-        std::future<ResultType> future;
+        uint64_t owner = cell->_owner.load(std::memory_order_acquire);
+        const bool free = posted
+          ? _stamped(owner, position, _posting) or (_stamped(owner, position, _taking) and _died(owner))
+          : _stamped(owner, position, _posting) and _died(owner);
 
-        if _stz_impl_EXPECTED(_nimata_impl::_validate_callable(callable_) == true)
+        if (free == false and posted == false)
         {
-          auto promise = new std::promise<ResultType>;
+          return false;
+        }
 
-          future = promise->get_future();
+        if (free and cell->_owner.compare_exchange_strong(owner, _stamp(position, _taking, self), std::memory_order_acq_rel))
+        {
+          // fails only if the consumer that died had claimed the position, which is now ours
+          uint64_t expected = position;
+          const uint64_t now = cell->_seq.load(std::memory_order_acquire);
 
-          std::lock_guard<std::mutex>(pool_->_queue_mtx), pool_->_queue.push(
-            [=]{ std::unique_ptr<std::promise<ResultType>>(promise)->set_value(callable_(arguments_...)); }
-          );
+          if (now == position + 1)
+          {
+            _shared->_head.compare_exchange_strong(expected, position + 1, std::memory_order_relaxed);
+            break;
+          }
 
-          _stz_impl_DBG_LVL_2(_stz_impl_DEBUG_MESSAGE("pushed a task with return value.");)
-        } 
-        else
-        {
-          _stz_impl_DBG_LVL_2(_stz_impl_DEBUG_MESSAGE("null task pushed.");)
+          // the producer died before posting
+          if (now == position)
+          {
+            _shared->_head.compare_exchange_strong(expected, position + 1, std::memory_order_relaxed);
+            cell->_seq.store(position + ring, std::memory_order_release);
+            ++_shared->_lost;
+            _released();
+          }
         }
 
-        return future;
+        position = _shared->_head.load(std::memory_order_relaxed);
       }
-    };
-  }
-//*///------------------------------------------------------------------------------------------------------------------
-  Pool::Pool(const signed N_) noexcept
-    : _size(_nimata_impl::_compute_number_of_threads(N_))
-    , _workers(new _nimata_impl::_worker[_size])
-  {
-    _stz_impl_DBG_LVL_0(_stz_impl_DEBUG_MESSAGE("%u thread%s aquired.", _size, _size == 1 ? "" : "s");)
-  }
+      else if (diff < 0)
+      {
+        return false;
+      }
+      else
+      {
+        position = _shared->_head.load(std::memory_order_relaxed);
+      }
+    }
 
-  template<Tracking T, typename Callable, typename... Arguments>
-  auto Pool::push
-  (
-    Callable&&     callable_,
-    Arguments&&... arguments_
-  ) noexcept -> _nimata_impl::_tracking<T, Callable, Arguments...>
-  {
-    return push(std::integral_constant<Tracking, T>(), callable_, arguments_...);
+    const char* const data = reinterpret_cast<const char*>(cell + 1);
+    kind_ = cell->_kind;
+    data_.assign(data, data + cell->_size);
+    cell->_seq.store(position + ring, std::memory_order_release);
+
+    _released();
+
+    return true;
   }
-  
-  template<typename Callable, typename... Arguments>
-  auto Pool::push(_nimata_impl::_detached, Callable&& callable_, Arguments&&... arguments_) noexcept -> void
+
+  // a cell whose consumer died after claiming it is released by the next producer in need of it
+  auto SharedQueue::_reclaim(_cell* const cell_, const uint64_t position_) noexcept -> bool
   {
-    if _stz_impl_EXPECTED(_nimata_impl::_validate_callable(callable_) == true)
+    uint64_t owner = cell_->_owner.load(std::memory_order_acquire);
+    if (_stamped(owner, position_, _taking) == false or _died(owner) == false
+      or cell_->_seq.load(std::memory_order_acquire) != position_ + 1
+      or _shared->_head.load(std::memory_order_acquire) <= position_)
     {
-      std::lock_guard<std::mutex>{_queue_mtx}, _queue.push(
-        [=]{ callable_(arguments_...); }
-      );
+      return false;
+    }
 
-      _stz_impl_DBG_LVL_2(_stz_impl_DEBUG_MESSAGE("pushed a task with no return value.");)
+    if (cell_->_owner.compare_exchange_strong(owner, _stamp(position_, _taking, static_cast<uint32_t>(getpid())),
+      std::memory_order_acq_rel))
+    {
+      cell_->_seq.store(position_ + _shared->_ring, std::memory_order_release);
+      ++_shared->_lost;
+      _released();
     }
-    else
+
+    return true;
+  }
+
+  void SharedQueue::_released() noexcept
+  {
+    _shared->_taken.fetch_add(1);
+    if (_shared->_producers.load() != 0)
     {
-      _stz_impl_DBG_LVL_2(_stz_impl_DEBUG_MESSAGE("null task pushed.");)
+      _wake(_shared->_taken, INT_MAX);
     }
+  }
 
-    return;
+  // the position and role are kept in the high half, truncated, and the process id in the low half
+  auto SharedQueue::_stamp(const uint64_t position_, const _role role_, const uint32_t pid_) noexcept -> uint64_t
+  {
+    return static_cast<uint64_t>(static_cast<uint32_t>(position_ * 2 + role_)) << 32 | pid_;
   }
 
-  template<typename Callable, typename... Arguments>
-  _stz_impl_NODISCARD_REASON("stz: push: wrap in a lambda if you don't use the return value.")
-  auto Pool::push
-  (
-    _nimata_impl::_attached,
-    Callable&&     callable_,
-    Arguments&&... arguments_
-  ) noexcept -> _nimata_impl::_future<Callable, Arguments...>
+  auto SharedQueue::_stamped(const uint64_t owner_, const uint64_t position_, const _role role_) noexcept -> bool
   {
-    return _nimata_impl::_push<_nimata_impl::_result<Callable, Arguments...>>::_impl(this, callable_, arguments_...);
+    return owner_ >> 32 == static_cast<uint32_t>(position_ * 2 + role_);
   }
 
-  template<typename Callable, typename... Arguments>
-  auto Pool::push
-  (
-    _nimata_impl::_inferred,
-    Callable&&     callable_,
-    Arguments&&... arguments
-  ) noexcept -> _nimata_impl::_auto<Callable, Arguments...>
+  // a process that exited is only gone once reaped by its parent
+  auto SharedQueue::_died(const uint64_t owner_) noexcept -> bool
   {
-    return _nimata_impl::_infer<_nimata_impl::_result<Callable, Arguments...>>::_impl(this, callable_, arguments...);
+    const pid_t pid = static_cast<pid_t>(owner_ & UINT32_MAX);
+
+    return pid != 0 and kill(pid, 0) != 0 and errno == ESRCH;
   }
 
-  void Pool::wait() const noexcept
+  void SharedQueue::_consume() noexcept
   {
-    if (_active == true)
+    uint32_t          kind;
+    std::vector<char> data;
+
+    while (_consuming.load(std::memory_order_relaxed))
     {
-      while (_queue.empty() == false)
+      // payloads are left to the other processes while every worker of this pool is busy
+      if (_pool->_front._pending >= _pool->size())
       {
         std::this_thread::sleep_for(std::chrono::nanoseconds(1));
-      };
+        continue;
+      }
 
-      for (unsigned k = 0; k < _size; ++k)
+      const uint32_t posted = _shared->_posted.load();
+      if (_take(kind, data) == false)
       {
-        while (_workers[k]._busy())
-        {
-          std::this_thread::sleep_for(std::chrono::nanoseconds(1));
-        }
+        ++_shared->_consumers;
+        _wait(_shared->_posted, posted);
+        --_shared->_consumers;
+        continue;
       }
 
-      _stz_impl_DBG_LVL_1(_stz_impl_DEBUG_MESSAGE("all threads finished their work.");)
+      const auto handler = _handlers.find(kind);
+      if _stz_impl_ABNORMAL(handler == _handlers.end())
+      {
+        _stz_impl_DBG_LVL_1(_stz_impl_DEBUG_MESSAGE("no handler for kind %u, payload dropped.", kind);)
+        continue;
+      }
+
+      ++_delivering;
+      _pool->_submit(_delivery{this, &handler->second, std::move(data)});
     }
   }
 
-  void Pool::work() noexcept
+  // shared futexes, so that processes mapping the same words wake each other, the timeout lets the stop flag be seen
+  void SharedQueue::_wait(std::atomic<uint32_t>& word_, const uint32_t expected_) noexcept
   {
-    _active = true;
+    timespec timeout = {0, 10000000};
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word_), FUTEX_WAIT, expected_, &timeout, nullptr, 0);
   }
 
-  void Pool::stop() noexcept
+  void SharedQueue::_wake(std::atomic<uint32_t>& word_, const int count_) noexcept
   {
-    _active = false;
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word_), FUTEX_WAKE, count_, nullptr, nullptr, 0);
   }
-
-  void Pool::size(const signed N_) noexcept
+# endif
+//*///------------------------------------------------------------------------------------------------------------------
+# if defined(_stz_impl_COROUTINES)
+  auto Pool::schedule() noexcept -> _nimata_impl::_schedule
   {
-    wait();
-
-    _size = _nimata_impl::_compute_number_of_threads(N_);
-
-    delete[] _workers;
-    _workers = new _nimata_impl::_worker[_size];
+    return _nimata_impl::_schedule{this};
   }
 
-  auto Pool::size() const noexcept -> unsigned
+  void _nimata_impl::_schedule::await_suspend(const std::coroutine_handle<> coroutine_) const noexcept
   {
-    return _size;
+    _pool->_enqueue([coroutine_]{ coroutine_.resume(); });
   }
 
-  auto Pool::parfor(const size_t from_, const size_t past_) noexcept -> _nimata_impl::_parfor<size_t>
+  template<typename Type>
+  class Future<Type>::_awaiter final
   {
-    return _nimata_impl::_parfor<size_t>(this, from_, past_);
-  }
+  public:
+    // an invalid future is not waited on, 'get' throws right away
+    bool await_ready() const noexcept
+    {
+      return _future.valid() == false or _future.ready();
+    }
 
-  auto Pool::parfor(const size_t size_) noexcept -> _nimata_impl::_parfor<size_t>
-  {
-    return _nimata_impl::_parfor<size_t>(this, 0, size_);
-  }
+    bool await_suspend(const std::coroutine_handle<> coroutine_) noexcept
+    {
+      _nimata_impl::_task* const resume = new _nimata_impl::_task([coroutine_]{ coroutine_.resume(); });
 
-  template<typename iterable, typename>
-  auto Pool::parfor(iterable&& thing_) noexcept -> _nimata_impl::_parfor<iterable>
-  {
-    return _nimata_impl::_parfor<iterable>(this, _nimata_impl::_begin(thing_), _nimata_impl::_end(thing_));
-  }
+      if (_future._shared->_suspend(resume))
+      {
+        return true;
+      }
 
-  template<typename Type, size_t Size>
-  auto Pool::parfor(Type (&array_)[Size]) noexcept -> _nimata_impl::_parfor<Type*>
+      delete resume;
+      return false;
+    }
+
+    auto await_resume() -> Type
+    {
+      return _future.get();
+    }
+
+    Future _future;
+  };
+
+  template<typename Type>
+  auto Future<Type>::operator co_await() noexcept -> _awaiter
   {
-    return _nimata_impl::_parfor<Type*>(this, array_, array_ + Size);
+    return _awaiter{std::move(*this)};
   }
 
-# define parfor(PARFOR_VARIABLE_DECLARATION, ...) parfor(__VA_ARGS__) = [&](PARFOR_VARIABLE_DECLARATION) -> void
-//*///------------------------------------------------------------------------------------------------------------------
-  Pool::~Pool() noexcept
+  namespace _nimata_impl
   {
-    wait();
+    template<typename Type>
+    struct _task_promise;
 
-    _alive = false;
-    _assignation_thread.join();
+    template<typename Type>
+    struct _task_result
+    {
+      template<typename Value>
+      void return_value(Value&& value_) noexcept(std::is_nothrow_constructible<Type, Value&&>::value)
+      {
+        _value.emplace(std::forward<Value>(value_));
+      }
 
-    delete[] _workers;
+      auto _take() -> Type
+      {
+        if (_exception)
+        {
+          std::rethrow_exception(_exception);
+        }
 
-    _stz_impl_DBG_LVL_0(_stz_impl_DEBUG_MESSAGE("all workers killed.");)
-  }
+        return std::move(*_value);
+      }
 
-  void Pool::_assign() noexcept
-  {
-    while _stz_impl_EXPECTED(_alive)
+      std::optional<Type> _value;
+      std::exception_ptr  _exception;
+    };
+
+    template<>
+    struct _task_result<void>
     {
-      if _stz_impl_ABNORMAL(_active == false)
+      void return_void() noexcept
+      {}
+
+      void _take()
       {
-        continue;
+        if (_exception)
+        {
+          std::rethrow_exception(_exception);
+        }
       }
 
-      for (unsigned k = 0; k < _size; ++k)
+      std::exception_ptr _exception;
+    };
+
+    template<typename Type>
+    struct _task_promise final : public _task_result<Type>
+    {
+      struct _final_awaiter final
       {
-        if (_workers[k]._busy())
+        bool await_ready() const noexcept
         {
-          continue;
+          return false;
         }
 
-        std::lock_guard<std::mutex> lock{_queue_mtx};
-        if (_queue.empty() == false)
+        // symmetric transfer to the awaiting coroutine, if there is one, the frame may be destroyed by 'get'
+        // as soon as it is marked done so nothing is read from it afterward
+        auto await_suspend(const std::coroutine_handle<_task_promise> self_) const noexcept -> std::coroutine_handle<>
         {
-          _workers[k]._task(std::move(_queue.front()));
-          _queue.pop();
+          _task_promise& promise = self_.promise();
+          const std::coroutine_handle<> continuation = promise._continuation;
+          promise._done.store(true, std::memory_order_release);
+
+          if (continuation)
+          {
+            return continuation;
+          }
+
+          return std::noop_coroutine();
+        }
+
+        void await_resume() const noexcept
+        {}
+      };
+
+      auto get_return_object() noexcept -> Task<Type>;
+
+      auto initial_suspend() const noexcept -> std::suspend_always
+      {
+        return {};
+      }
+
+      auto final_suspend() const noexcept -> _final_awaiter
+      {
+        return {};
+      }
+
+      void unhandled_exception() noexcept
+      {
+        this->_exception = std::current_exception();
+      }
+
+      std::coroutine_handle<> _continuation;
+      std::atomic_bool        _done = {false};
+    };
+  }
+
+  template<typename Type>
+  class Task final
+  {
+  public:
+    using promise_type = _nimata_impl::_task_promise<Type>;
+
+    Task(Task&& other_) noexcept
+      : _handle(other_._handle)
+    {
+      other_._handle = nullptr;
+    }
+
+    Task(const Task&) = delete;
+
+    // awaiting a task starts it and resumes the awaiting coroutine once it is done
+    auto operator co_await() noexcept
+    {
+      struct _awaiter final
+      {
+        bool await_ready() const noexcept
+        {
+          return false;
+        }
+
+        auto await_suspend(const std::coroutine_handle<> coroutine_) noexcept -> std::coroutine_handle<>
+        {
+          _coroutine.promise()._continuation = coroutine_;
+          return _coroutine;
+        }
 
-          _stz_impl_DBG_LVL_2(_stz_impl_DEBUG_MESSAGE("assigned to worker thread #%02u.", k);)
+        auto await_resume() -> Type
+        {
+          return _coroutine.promise()._take();
         }
+
+        std::coroutine_handle<promise_type> _coroutine;
+      };
+
+      return _awaiter{_handle};
+    }
+
+    // starts the task on the calling thread then blocks until it is done
+    auto get() -> Type
+    {
+      _handle.resume();
+
+      while (_handle.promise()._done.load(std::memory_order_acquire) == false)
+      {
+        std::this_thread::sleep_for(std::chrono::nanoseconds(1));
+      }
+
+      return _handle.promise()._take();
+    }
+
+    ~Task() noexcept
+    {
+      if (_handle)
+      {
+        _handle.destroy();
       }
     }
+
+  private:
+    friend promise_type;
+    explicit Task(const std::coroutine_handle<promise_type> handle_) noexcept
+      : _handle(handle_)
+    {}
+    std::coroutine_handle<promise_type> _handle;
+  };
+
+  template<typename Type>
+  auto _nimata_impl::_task_promise<Type>::get_return_object() noexcept -> Task<Type>
+  {
+    return Task<Type>(std::coroutine_handle<_task_promise>::from_promise(*this));
   }
+# endif
 //*///------------------------------------------------------------------------------------------------------------------
 # undef cyclic_async
   void cyclic_async();
@@ -995,6 +6983,13 @@ inline namespace nimata
 # undef _stz_impl_DBG_LVL_1
 # undef _stz_impl_DBG_LVL_0
 # undef _stz_impl_DEBUG_MESSAGE
+# undef _stz_impl_PTHREAD
+# undef _stz_impl_AFFINITY
+# undef _stz_impl_REACTOR
+# undef _stz_impl_IO_URING
+# undef _stz_impl_COROUTINES
+# undef _stz_impl_FIBERS
+# undef _stz_impl_SHARED
 //*///------------------------------------------------------------------------------------------------------------------
 #else
 #error "nimata: Concurrent threads are required"
@@ -0,0 +1,75 @@
+#undef NDEBUG
+#include <cassert>
+#include <chrono>
+#include <future>
+#include <thread>
+#include "Nimata.hpp"
+
+static void test_own_arena()
+{
+  std::atomic_int count{0};
+  stz::Pool pool(4);
+
+  for (unsigned k = 0; k < 10000; ++k)
+  {
+    pool.push([&]{ ++count; });
+  }
+  std::future<int> doubled = pool.push([](int x){ return x * 2; }, 21);
+  pool.wait();
+  assert(count == 10000 and doubled.get() == 42);
+
+  pool.size(2);
+  assert(pool.size() == 2);
+  pool.parfor(size_t k, 100)
+  {
+    ++count;
+  };
+  assert(count == 10100);
+}
+
+// pools sharing an arena share its threads, each within its own limit
+static void test_shared_arena()
+{
+  stz::Arena arena(3);
+  std::atomic_int count{0}, running{0}, peak{0};
+  {
+    stz::Pool first(arena, 1), second(arena, 2);
+
+    for (unsigned k = 0; k < 50; ++k)
+    {
+      first.push([&]
+      {
+        int now = ++running, seen = peak;
+        while (now > seen and not peak.compare_exchange_weak(seen, now));
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+        --running;
+      });
+    }
+    first.wait();
+    assert(peak == 1);
+
+    for (unsigned k = 0; k < 100; ++k)
+    {
+      first.push([&]{ ++count; });
+      second.push([&]{ ++count; });
+    }
+  }
+  assert(count == 200);
+}
+
+static void test_process_arena()
+{
+  std::atomic_int count{0};
+  stz::Pool pool(stz::arena(), 0);
+
+  pool.push([&]{ ++count; });
+  pool.wait();
+  assert(count == 1);
+}
+
+int main()
+{
+  test_own_arena();
+  test_shared_arena();
+  test_process_arena();
+}
@@ -0,0 +1,47 @@
+#undef NDEBUG
+#include <cassert>
+#include <chrono>
+#include <thread>
+#include "Nimata.hpp"
+
+static std::atomic_long counter{0};
+
+static void tiny()
+{
+  counter.fetch_add(1, std::memory_order_relaxed);
+}
+
+// tiny tasks are handed over in batches, none is lost or run twice
+static void test_tiny(stz::Pool& pool)
+{
+  for (unsigned round = 0; round < 3; ++round)
+  {
+    counter = 0;
+    for (unsigned k = 0; k < 1000000; ++k)
+    {
+      pool.push(tiny);
+    }
+    pool.wait();
+    assert(counter == 1000000);
+  }
+}
+
+// long tasks are not grouped, they still spread over every worker
+static void test_long(stz::Pool& pool)
+{
+  const auto start = std::chrono::steady_clock::now();
+  for (unsigned k = 0; k < 8; ++k)
+  {
+    pool.push([]{ std::this_thread::sleep_for(std::chrono::milliseconds(50)); });
+  }
+  pool.wait();
+
+  assert(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(190));
+}
+
+int main()
+{
+  stz::Pool pool(4);
+  test_tiny(pool);
+  test_long(pool);
+}
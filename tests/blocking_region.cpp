@@ -0,0 +1,121 @@
+#undef NDEBUG
+#include <cassert>
+#include <chrono>
+#include <thread>
+#include "Nimata.hpp"
+
+using namespace std::chrono;
+
+static auto run_sleepers(stz::Pool& pool, const bool declared) -> steady_clock::duration
+{
+  const auto start = steady_clock::now();
+  for (unsigned k = 0; k < 16; ++k)
+  {
+    pool.push([declared]
+    {
+      if (declared)
+      {
+        stz::blocking_region region;
+        std::this_thread::sleep_for(milliseconds(50));
+      }
+      else
+      {
+        std::this_thread::sleep_for(milliseconds(50));
+      }
+    });
+  }
+  pool.wait();
+  return steady_clock::now() - start;
+}
+
+// spares run work while workers block, so blocking tasks overlap more
+static void test_compensation(stz::Pool& pool)
+{
+  const steady_clock::duration plain = run_sleepers(pool, false);
+  const steady_clock::duration compensated = run_sleepers(pool, true);
+  assert(compensated < plain * 3 / 4);
+}
+
+// short tasks keep running while every worker blocks
+static void test_progress(stz::Pool& pool)
+{
+  std::atomic_int done{0};
+
+  const auto start = steady_clock::now();
+  for (unsigned k = 0; k < 4; ++k)
+  {
+    pool.push([]
+    {
+      stz::blocking_region region;
+      {
+        stz::blocking_region nested;
+      }
+      std::this_thread::sleep_for(milliseconds(100));
+    });
+  }
+  std::this_thread::sleep_for(milliseconds(10));
+  for (unsigned k = 0; k < 100; ++k)
+  {
+    pool.push([&]{ ++done; });
+  }
+  while (done < 100)
+  {
+    std::this_thread::sleep_for(milliseconds(1));
+  }
+
+  assert(steady_clock::now() - start < milliseconds(90));
+  pool.wait();
+}
+
+// spares have worker-local instances of their own
+static void test_local(stz::Pool& pool)
+{
+  stz::Pool::local<int> counts(pool);
+
+  for (unsigned k = 0; k < 8; ++k)
+  {
+    pool.push([]{ stz::blocking_region region; std::this_thread::sleep_for(milliseconds(5)); });
+  }
+  pool.parfor(size_t k, 1000)
+  {
+    ++*counts;
+  };
+  pool.wait();
+
+  assert(counts.combine(0, [](int a, int& b){ return a + b; }) == 1000);
+}
+
+static void test_limit()
+{
+  stz::Arena arena(4);
+  stz::Pool limited(arena, 2);
+  std::atomic_int inside{0}, most{0};
+
+  for (unsigned k = 0; k < 40; ++k)
+  {
+    limited.push([&]
+    {
+      int now = ++inside, seen = most;
+      while (now > seen and not most.compare_exchange_weak(seen, now));
+      std::this_thread::sleep_for(milliseconds(1));
+      --inside;
+    });
+  }
+  limited.wait();
+
+  assert(most <= 2);
+}
+
+int main()
+{
+  // does nothing outside of a worker
+  {
+    stz::blocking_region region;
+  }
+
+  stz::Pool pool(4);
+  test_compensation(pool);
+  test_progress(pool);
+  test_local(pool);
+  test_limit();
+}
@@ -0,0 +1,131 @@
+#undef NDEBUG
+#include <cassert>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Nimata.hpp"
+
+// a full channel refuses sends and keeps its values, whatever its capacity
+static void test_capacity(const size_t capacity, const size_t held)
+{
+  stz::Channel<int> channel(capacity);
+  assert(channel.capacity() == held);
+
+  for (int k = 0; k < static_cast<int>(held); ++k)
+  {
+    assert(channel.try_send(k));
+  }
+  assert(channel.try_send(-1) == false);
+  assert(channel.size() == held);
+
+  for (int lap = 0; lap < 3; ++lap)
+  {
+    int value = -1;
+    assert(channel.try_recv(value) and value == lap);
+    assert(channel.try_send(static_cast<int>(held) + lap));
+    assert(channel.try_send(-1) == false);
+    assert(channel.size() == held);
+  }
+
+  int value;
+  size_t received = 0;
+  while (channel.try_recv(value))
+  {
+    ++received;
+  }
+  assert(received == held and channel.size() == 0);
+}
+
+static void test_values()
+{
+  stz::Channel<std::string> channel(3);
+  std::string a = "a";
+  assert(channel.try_send(a) and a == "a");
+  assert(channel.try_send(std::string("b")) and channel.try_send("c"));
+
+  std::string d = "d";
+  assert(channel.try_send(std::move(d)) == false and d == "d");
+
+  std::string received;
+  assert(channel.try_recv(received) and received == "a");
+
+  channel.close();
+  assert(channel.send("e") == false);
+  assert(channel.recv(received) and received == "b");
+  assert(channel.recv(received) and received == "c");
+  assert(channel.recv(received) == false);
+}
+
+// every value sent by several producers is received exactly once, even through a single cell
+static void test_mpmc(const size_t capacity)
+{
+  stz::Channel<long> channel(capacity);
+  std::atomic_long total{0};
+
+  std::vector<std::thread> producers;
+  for (int p = 0; p < 3; ++p)
+  {
+    producers.emplace_back([&]{ for (long k = 1; k <= 5000; ++k) assert(channel.send(k)); });
+  }
+
+  std::vector<std::thread> consumers;
+  for (int c = 0; c < 2; ++c)
+  {
+    consumers.emplace_back([&]{ long value; while (channel.recv(value)) { total += value; assert(channel.size() <= capacity + 1); } });
+  }
+
+  for (std::thread& producer : producers)
+  {
+    producer.join();
+  }
+  channel.close();
+  for (std::thread& consumer : consumers)
+  {
+    consumer.join();
+  }
+
+  assert(total == 3 * 5000L * 5001 / 2);
+}
+
+static void test_receive()
+{
+  stz::Pool pool(4);
+  std::atomic_long sum{0};
+  std::atomic_int  inside{0};
+  long last    = 0;
+  bool ordered = true;
+  {
+    stz::Channel<long> mailbox(64);
+    mailbox.receive(pool, [&](long& value){
+      assert(++inside == 1);
+      ordered = ordered and value > last;
+      last = value;
+      sum += value;
+      --inside;
+    });
+
+    for (long k = 1; k <= 20000; ++k)
+    {
+      mailbox.send(k);
+    }
+
+    while (sum != 20000L * 20001 / 2)
+    {
+      std::this_thread::yield();
+    }
+  }
+  assert(ordered);
+}
+
+int main()
+{
+  test_capacity(0, 1);
+  test_capacity(1, 1);
+  test_capacity(2, 2);
+  test_capacity(5, 5);
+  test_values();
+  test_mpmc(1);
+  test_mpmc(2);
+  test_mpmc(16);
+  test_receive();
+}
@@ -0,0 +1,100 @@
+#undef NDEBUG
+#include <cassert>
+#include <chrono>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Nimata.hpp"
+
+static void test_when_all(stz::Pool& pool)
+{
+  auto all = stz::when_all(pool.push<stz::chained>([]{ return 1; }),
+                           pool.push<stz::chained>([]{ return std::string("x"); }),
+                           pool.push<stz::chained>([]{})).get();
+  assert(std::get<0>(all).get() == 1 and std::get<1>(all).get() == "x");
+  std::get<2>(all).get();
+
+  for (unsigned round = 0; round < 200; ++round)
+  {
+    std::vector<stz::Future<int>> futures;
+    for (unsigned k = 0; k < 20; ++k)
+    {
+      futures.push_back(pool.push<stz::chained>([k]{ return static_cast<int>(k); }));
+    }
+
+    stz::Future<int> sum = stz::when_all(std::move(futures)).then(pool, [](std::vector<stz::Future<int>> ready)
+    {
+      int total = 0;
+      for (stz::Future<int>& future : ready)
+      {
+        total += future.get();
+      }
+      return total;
+    });
+    assert(sum.get() == 190);
+  }
+
+  assert(stz::when_all(std::vector<stz::Future<int>>()).get().empty());
+}
+
+static void test_when_any(stz::Pool& pool)
+{
+  std::vector<stz::Future<int>> replicas;
+  replicas.push_back(pool.push<stz::chained>([]{ std::this_thread::sleep_for(std::chrono::milliseconds(300)); return 1; }));
+  replicas.push_back(pool.push<stz::chained>([]{ return 2; }));
+
+  const auto start = std::chrono::steady_clock::now();
+  auto first = stz::when_any(std::move(replicas)).get();
+  assert(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(200));
+  assert(first.index == 1 and first.futures[1].get() == 2);
+
+  // the futures that lost can still be chained
+  assert(first.futures[0].then(pool, [](int x){ return x + 10; }).get() == 11);
+
+  auto mixed = stz::when_any(pool.push<stz::chained>([]{ return 3; }), pool.push<stz::chained>([]{})).get();
+  assert(mixed.index <= 1);
+
+  assert(stz::when_any(std::vector<stz::Future<int>>()).get().index == size_t(-1));
+}
+
+// invalid futures count as ready at once and are held as is
+static void test_invalid(stz::Pool& pool)
+{
+  std::vector<stz::Future<int>> futures;
+  futures.push_back(pool.push<stz::chained>([]{ std::this_thread::sleep_for(std::chrono::milliseconds(20)); return 1; }));
+  futures.push_back(stz::Future<int>());
+  auto all = stz::when_all(std::move(futures)).get();
+  assert(all[0].get() == 1 and not all[1].valid());
+
+  stz::Future<int> moved = pool.push<stz::chained>([]{ return 2; });
+  stz::Future<int> taken = std::move(moved);
+  auto both = stz::when_all(std::move(moved), std::move(taken)).get();
+  assert(std::get<1>(both).get() == 2);
+
+  bool thrown = false;
+  try
+  {
+    std::get<0>(both).get();
+  }
+  catch (const std::future_error& error)
+  {
+    thrown = (error.code() == std::future_errc::no_state);
+  }
+  assert(thrown);
+
+  std::vector<stz::Future<int>> replicas;
+  replicas.push_back(pool.push<stz::chained>([]{ std::this_thread::sleep_for(std::chrono::milliseconds(300)); return 1; }));
+  replicas.push_back(stz::Future<int>());
+  auto first = stz::when_any(std::move(replicas)).get();
+  assert(first.index == 1 and first.futures[0].get() == 1);
+}
+
+int main()
+{
+  stz::Pool pool(4);
+  test_when_all(pool);
+  test_when_any(pool);
+  test_invalid(pool);
+  pool.wait();
+}
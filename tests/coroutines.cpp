@@ -0,0 +1,65 @@
+#undef NDEBUG
+#include <cassert>
+#include "Nimata.hpp"
+
+#if defined(_stz_impl_COROUTINES) or (defined(__cpp_impl_coroutine) and (__cplusplus >= 202002L))
+static stz::Pool pool(3);
+
+static stz::Task<int> leaf(const int x)
+{
+  co_await pool.schedule();
+  assert(stz::this_worker::index() >= 0);
+  co_return x * 2;
+}
+
+static stz::Task<int> middle(const int x)
+{
+  const int doubled = co_await leaf(x);
+  co_return co_await pool.push<stz::chained>([](const int y){ return y + 1; }, doubled);
+}
+
+static stz::Task<> top(std::atomic_int& sum)
+{
+  for (unsigned k = 0; k < 100; ++k)
+  {
+    sum += co_await middle(static_cast<int>(k));
+  }
+}
+
+static stz::Task<int> thrower()
+{
+  co_await pool.schedule();
+  throw 5;
+  co_return 1;
+}
+
+int main()
+{
+  std::atomic_int sum{0};
+  top(sum).get();
+  assert(sum == 2 * 4950 + 100);
+
+  try
+  {
+    thrower().get();
+    assert(false);
+  }
+  catch (const int error)
+  {
+    assert(error == 5);
+  }
+
+  {
+    auto unstarted = leaf(1);
+  }
+
+  // 'get' returns and destroys the frame while the worker completing it may still be suspending it
+  for (int k = 0; k < 20000; ++k)
+  {
+    assert(leaf(k).get() == 2 * k);
+  }
+}
+#else
+int main()
+{}
+#endif
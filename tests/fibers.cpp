@@ -0,0 +1,124 @@
+#undef NDEBUG
+#include <cassert>
+#include <thread>
+#include <vector>
+#include "Nimata.hpp"
+
+#if defined(__linux__)
+
+// tasks waiting on a latch opened by the last of them only finish if waiting frees their worker
+static void test_latch(stz::Pool& pool)
+{
+  stz::Latch latch(1);
+  std::atomic_int released{0};
+
+  for (unsigned k = 0; k < 10000; ++k)
+  {
+    pool.push([&]{ latch.wait(); ++released; });
+  }
+  pool.push([&]{ latch.count_down(); });
+  pool.wait();
+
+  assert(released == 10000);
+}
+
+static void test_futures(stz::Pool& pool)
+{
+  std::vector<stz::Future<int>> futures(1000);
+  std::atomic_long sum{0};
+  stz::Latch ready(1);
+
+  for (unsigned k = 0; k < 1000; ++k)
+  {
+    pool.push([&, k]{ ready.wait(); sum += futures[k].get(); });
+  }
+  for (unsigned k = 0; k < 1000; ++k)
+  {
+    futures[k] = pool.push<stz::chained>([k]{ return static_cast<int>(k); });
+  }
+  ready.count_down();
+  pool.wait();
+
+  assert(sum == 999 * 1000 / 2);
+}
+
+static void test_channel(stz::Pool& pool)
+{
+  stz::Channel<int> channel(4);
+  std::atomic_long sum{0};
+
+  for (unsigned k = 0; k < 8; ++k)
+  {
+    pool.push([&]{ int value; while (channel.recv(value)) sum += value; });
+  }
+  pool.push([&]{ for (int k = 1; k <= 1000; ++k) channel.send(k); channel.close(); });
+  pool.wait();
+
+  assert(sum == 1000 * 1001 / 2);
+}
+
+// a fiber waiting inside a blocking region keeps its worker, so the region ends where it began and spares stand in
+static void test_blocking_region(stz::Pool& pool)
+{
+  stz::Latch latch(1);
+  std::atomic_int kept{0};
+
+  for (unsigned k = 0; k < 2; ++k)
+  {
+    pool.push([&]
+    {
+      const std::thread::id before = std::this_thread::get_id();
+      {
+        stz::blocking_region region;
+        latch.wait();
+        if (std::this_thread::get_id() == before)
+        {
+          ++kept;
+        }
+      }
+    });
+  }
+  pool.push([&]{ latch.count_down(); });
+  pool.wait();
+
+  assert(kept == 2);
+}
+
+// buffered tasks of a producer feeding a bounded pool still run on fibers
+static void test_producer(stz::Pool& pool)
+{
+  pool.capacity(16);
+
+  stz::Latch latch(1);
+  std::atomic_int released{0};
+  {
+    stz::Producer producer(pool, 8);
+    for (unsigned k = 0; k < 1000; ++k)
+    {
+      producer.push([&]{ latch.wait(); ++released; });
+    }
+  }
+  pool.capacity(0);
+  pool.push([&]{ latch.count_down(); });
+  pool.wait();
+
+  assert(released == 1000);
+}
+
+int main()
+{
+  stz::Pool pool(2);
+  pool.fibers(true);
+  assert(pool.fibers());
+
+  test_latch(pool);
+  test_futures(pool);
+  test_channel(pool);
+  test_blocking_region(pool);
+  test_producer(pool);
+  pool.fibers(false);
+}
+
+#else
+int main() {}
+#endif
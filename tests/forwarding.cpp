@@ -0,0 +1,121 @@
+#undef NDEBUG
+#include <cassert>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Nimata.hpp"
+
+static std::atomic_int copies{0};
+static std::atomic_long total{0};
+
+struct Big
+{
+  std::vector<int> data;
+  Big() : data(1000, 1) {}
+  Big(const Big& other) : data(other.data) { ++copies; }
+  Big(Big&& other) noexcept : data(std::move(other.data)) {}
+};
+
+static void take(Big big)
+{
+  total += static_cast<long>(big.data.size());
+}
+
+static auto take_pointer(std::unique_ptr<int> pointer) -> int
+{
+  return *pointer;
+}
+
+struct MoveOnly
+{
+  std::unique_ptr<int> value;
+  auto operator()() -> int { return *value; }
+};
+
+// arguments are moved all the way into the task, an lvalue is copied once
+static void test_copies(stz::Pool& pool)
+{
+  {
+    Big big;
+    pool.push(take, std::move(big));
+    pool.wait();
+    assert(copies == 0 and total == 1000);
+  }
+  {
+    Big big;
+    pool.push(take, big);
+    pool.wait();
+    assert(copies == 1);
+  }
+  copies = 0;
+
+  pool.push<stz::stray>(take, Big());
+  assert(pool.try_push(take, Big()));
+  stz::Timer timer = pool.push_after(std::chrono::milliseconds(1), take, Big());
+  pool.strand(1).push(take, Big());
+  pool.push_keyed(2, take, Big());
+  {
+    stz::Producer producer(pool);
+    producer.push(take, Big());
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  pool.wait();
+
+  assert(copies == 0);
+}
+
+static void test_move_only(stz::Pool& pool)
+{
+  assert(pool.push<stz::bound>(take_pointer, std::unique_ptr<int>(new int(5))).get() == 5);
+  assert(pool.push(MoveOnly{std::unique_ptr<int>(new int(6))}).get() == 6);
+  assert(pool.push<stz::chained>(take_pointer, std::unique_ptr<int>(new int(7))).get() == 7);
+}
+
+static void test_references(stz::Pool& pool)
+{
+  const std::string text = "abc";
+  assert(pool.push([](const std::string& x){ return x.size(); }, text).get() == 3 and text == "abc");
+
+  int counter = 0;
+  pool.push([](int& x){ ++x; }, std::ref(counter));
+  pool.wait();
+  assert(counter == 1);
+}
+
+// a bound task dropped by a full queue breaks its promise instead of leaking it
+static void test_dropped(stz::Pool& pool)
+{
+  pool.stop();
+  pool.capacity(1, stz::drop_oldest);
+
+  std::future<int> lost = pool.push<stz::bound>([]{ return 1; });
+  std::future<int> kept = pool.push<stz::bound>([]{ return 2; });
+
+  bool broken = false;
+  try
+  {
+    lost.get();
+  }
+  catch (const std::future_error& error)
+  {
+    broken = error.code() == std::future_errc::broken_promise;
+  }
+  assert(broken);
+
+  pool.work();
+  assert(kept.get() == 2);
+  pool.capacity(0);
+}
+
+int main()
+{
+  stz::Pool pool(4);
+  test_copies(pool);
+  test_move_only(pool);
+  test_references(pool);
+  test_dropped(pool);
+}
@@ -0,0 +1,89 @@
+#undef NDEBUG
+#include <cassert>
+#include <future>
+#include <string>
+#include <vector>
+#include "Nimata.hpp"
+
+static void test_chains(stz::Pool& pool)
+{
+  stz::Future<int> answer = pool.push<stz::chained>([](int x){ return x + 1; }, 41);
+  assert(answer.valid());
+  assert(answer.get() == 42 and not answer.valid());
+
+  stz::Future<int> length = pool.push<stz::chained>([]{ return std::string("ab"); })
+    .then(pool, [](std::string text){ return text + "c"; })
+    .then(pool, [](std::string text){ return static_cast<int>(text.size()); });
+  assert(length.get() == 3);
+
+  std::atomic_int count{0};
+  stz::Future<void> done = pool.push<stz::chained>([&]{ ++count; }).then(pool, [&]{ ++count; });
+  done.wait();
+  assert(count == 2 and done.ready());
+
+  // a continuation added once the result is set still runs
+  stz::Future<int> ready = pool.push<stz::chained>([]{ return 1; });
+  ready.wait();
+  assert(ready.then(pool, [](int x){ return x * 10; }).get() == 10);
+
+  std::vector<stz::Future<long>> futures;
+  for (unsigned k = 0; k < 1000; ++k)
+  {
+    futures.push_back(pool.push<stz::chained>([k]{ return static_cast<long>(k); }).then(pool, [](long x){ return x * 2; }));
+  }
+  long sum = 0;
+  for (stz::Future<long>& future : futures)
+  {
+    sum += future.get();
+  }
+  assert(sum == 999000);
+
+  // futures dropped before their result is set
+  for (unsigned k = 0; k < 100; ++k)
+  {
+    pool.push<stz::chained>([]{ return std::string(100, 'x'); });
+  }
+  pool.wait();
+}
+
+static void test_invalid(stz::Pool& pool)
+{
+  stz::Future<int> invalid;
+  assert(not invalid.valid() and not invalid.ready() and not invalid.broken());
+
+  invalid.wait();
+
+  bool thrown = false;
+  try
+  {
+    invalid.get();
+  }
+  catch (const std::future_error& error)
+  {
+    thrown = error.code() == std::future_errc::no_state;
+  }
+  assert(thrown);
+
+  assert(not invalid.then(pool, [](int x){ return x; }).valid());
+
+  // a consumed future is invalid as well
+  stz::Future<void> consumed = pool.push<stz::chained>([]{});
+  consumed.get();
+  thrown = false;
+  try
+  {
+    consumed.get();
+  }
+  catch (const std::future_error& error)
+  {
+    thrown = error.code() == std::future_errc::no_state;
+  }
+  assert(thrown);
+}
+
+int main()
+{
+  stz::Pool pool(3);
+  test_chains(pool);
+  test_invalid(pool);
+}
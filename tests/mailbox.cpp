@@ -0,0 +1,57 @@
+#undef NDEBUG
+#include <cassert>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "Nimata.hpp"
+
+// pools sharing an arena hand batches through the workers' mailboxes, every task runs exactly once
+static void test_exactly_once()
+{
+  const unsigned count = 200000;
+
+  stz::Arena arena(4);
+  std::vector<std::unique_ptr<stz::Pool>> pools;
+  std::vector<std::unique_ptr<std::atomic_uchar[]>> runs;
+  for (unsigned k = 0; k < 3; ++k)
+  {
+    pools.emplace_back(new stz::Pool(arena, 4));
+    runs.emplace_back(new std::atomic_uchar[count]);
+    for (unsigned n = 0; n < count; ++n)
+    {
+      runs[k][n] = 0;
+    }
+  }
+
+  std::vector<std::thread> pushers;
+  for (unsigned k = 0; k < 3; ++k)
+  {
+    pushers.emplace_back([&, k]
+    {
+      std::atomic_uchar* const flags = runs[k].get();
+      for (unsigned n = 0; n < count; ++n)
+      {
+        pools[k]->push([flags, n]{ flags[n].fetch_add(1, std::memory_order_relaxed); });
+      }
+      pools[k]->wait();
+    });
+  }
+  for (std::thread& pusher : pushers)
+  {
+    pusher.join();
+  }
+
+  for (unsigned k = 0; k < 3; ++k)
+  {
+    assert(pools[k]->depth() == 0);
+    for (unsigned n = 0; n < count; ++n)
+    {
+      assert(runs[k][n] == 1);
+    }
+  }
+}
+
+int main()
+{
+  test_exactly_once();
+}
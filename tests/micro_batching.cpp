@@ -0,0 +1,64 @@
+#undef NDEBUG
+#include <cassert>
+#include <chrono>
+#include <future>
+#include <thread>
+#include "Nimata.hpp"
+
+static std::atomic_uint work_count{0};
+
+static void work_1()    {        ++work_count; }
+static void work_2(int) {        ++work_count; }
+static int  work_3()    { return static_cast<int>(++work_count); }
+static int  work_4(int) { return static_cast<int>(++work_count); }
+
+// tasks of every kind are grouped into batches, counters settle once per batch
+static void test_counts(stz::Pool& pool)
+{
+  for (unsigned round = 0; round < 3; ++round)
+  {
+    work_count = 0;
+
+    std::future<int> third, fourth;
+    for (unsigned k = 0; k < 10000; ++k)
+    {
+      pool.push(work_1);
+      pool.push(work_2, 0);
+      third  = pool.push(work_3);
+      fourth = pool.push(work_4, 0);
+      pool.push<stz::stray>(work_3);
+    }
+    pool.wait();
+
+    assert(work_count == 50000 and third.get() > 0 and fourth.get() > 0);
+    assert(pool.depth() == 0);
+  }
+}
+
+// a pool limited below its arena's size never runs more tasks at once, batches included
+static void test_limit(stz::Pool& pool)
+{
+  std::atomic_int inside{0}, most{0};
+
+  for (unsigned k = 0; k < 2000; ++k)
+  {
+    pool.push([&]
+    {
+      int now = ++inside, seen = most;
+      while (now > seen and not most.compare_exchange_weak(seen, now));
+      std::this_thread::sleep_for(std::chrono::microseconds(10));
+      --inside;
+    });
+  }
+  pool.wait();
+
+  assert(most <= 2);
+}
+
+int main()
+{
+  stz::Arena arena(4);
+  stz::Pool pool(arena, 2);
+  test_counts(pool);
+  test_limit(pool);
+}
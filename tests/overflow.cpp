@@ -0,0 +1,176 @@
+#undef NDEBUG
+#include <cassert>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Nimata.hpp"
+
+using std::chrono::milliseconds;
+
+static void test_try_push(stz::Pool& pool)
+{
+  std::atomic_int ran{0};
+
+  pool.capacity(4);
+  assert(pool.capacity() == 4);
+
+  int accepted = 0;
+  for (unsigned k = 0; k < 20; ++k)
+  {
+    accepted += pool.try_push([&]{ std::this_thread::sleep_for(milliseconds(20)); ++ran; }) ? 1 : 0;
+  }
+  assert(accepted >= 4 and accepted < 20 and pool.depth() <= 4);
+
+  pool.wait();
+  assert(ran == accepted);
+}
+
+// the pushing thread is slowed down to the pace of the workers
+static void test_block(stz::Pool& pool)
+{
+  std::atomic_int ran{0};
+  std::atomic_size_t deepest{0};
+  std::atomic_bool watching{true};
+
+  std::thread watcher([&]
+  {
+    while (watching)
+    {
+      const size_t depth = pool.depth();
+      if (depth > deepest)
+      {
+        deepest = depth;
+      }
+      std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+  });
+  for (unsigned k = 0; k < 40; ++k)
+  {
+    pool.push([&]{ std::this_thread::sleep_for(milliseconds(2)); ++ran; });
+  }
+  pool.wait();
+  watching = false;
+  watcher.join();
+
+  assert(ran == 40 and deepest <= 4);
+}
+
+static void test_drop_oldest(stz::Pool& pool)
+{
+  std::vector<int> done;
+  std::mutex done_mtx;
+
+  pool.capacity(3, stz::drop_oldest);
+  for (unsigned k = 0; k < 2; ++k)
+  {
+    pool.push([]{ std::this_thread::sleep_for(milliseconds(50)); });
+  }
+  std::this_thread::sleep_for(milliseconds(10));
+  for (int k = 0; k < 10; ++k)
+  {
+    pool.push([&, k]{ std::lock_guard<std::mutex> lock(done_mtx); done.push_back(k); });
+  }
+  pool.wait();
+
+  assert(done.size() >= 3 and done.size() < 10 and done.back() == 9);
+}
+
+static void test_caller_runs(stz::Pool& pool)
+{
+  const std::thread::id caller = std::this_thread::get_id();
+  std::atomic_int on_caller{0};
+
+  pool.capacity(1, stz::caller_runs);
+  for (unsigned k = 0; k < 10; ++k)
+  {
+    pool.push([&]
+    {
+      std::this_thread::sleep_for(milliseconds(5));
+      if (std::this_thread::get_id() == caller)
+      {
+        ++on_caller;
+      }
+    });
+  }
+  pool.wait();
+
+  assert(on_caller > 0);
+}
+
+// a worker pushing to its own full pool runs the task itself rather than waiting forever
+static void test_nested(stz::Pool& pool)
+{
+  std::atomic_int nested{0};
+
+  pool.capacity(1, stz::block);
+  for (unsigned k = 0; k < 4; ++k)
+  {
+    pool.push([&]
+    {
+      for (unsigned n = 0; n < 10; ++n)
+      {
+        pool.push([&]{ ++nested; });
+      }
+    });
+  }
+  pool.wait();
+
+  assert(nested == 40);
+}
+
+// internal work such as continuations is not subject to the capacity
+static void test_unbounded(stz::Pool& pool)
+{
+  pool.capacity(0);
+  assert(pool.push<stz::chained>([]{ return 1; }).then(pool, [](int x){ return x + 1; }).get() == 2);
+}
+
+// tiny tasks are handed out in batches, those lined up behind a running one are not queued anymore
+static void test_depth(stz::Pool& pool)
+{
+  pool.capacity(0);
+  for (unsigned k = 0; k < 10000; ++k)
+  {
+    pool.push([]{});
+  }
+  pool.wait();
+
+  std::atomic_bool open{false};
+  std::atomic_uint started{0};
+  auto gated = [&]{ ++started; while (not open) { std::this_thread::yield(); } };
+
+  pool.capacity(1000);
+  while (pool.try_push(gated))
+  {
+  }
+  while (started != pool.size())
+  {
+    std::this_thread::yield();
+  }
+
+  // once every mailbox is full the queue stops draining, it is then filled up again
+  std::this_thread::sleep_for(milliseconds(50));
+  while (pool.try_push(gated))
+  {
+  }
+  std::this_thread::sleep_for(milliseconds(50));
+  assert(pool.depth() == 1000);
+
+  open = true;
+  pool.wait();
+  assert(pool.depth() == 0);
+  pool.capacity(0);
+}
+
+int main()
+{
+  stz::Pool pool(2);
+  test_try_push(pool);
+  test_block(pool);
+  test_drop_oldest(pool);
+  test_caller_runs(pool);
+  test_nested(pool);
+  test_unbounded(pool);
+  test_depth(pool);
+}
@@ -0,0 +1,95 @@
+#undef NDEBUG
+#include <cassert>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Nimata.hpp"
+
+static void test_modes(stz::Pool& pool)
+{
+  for (unsigned mode = 0; mode < 4; ++mode)
+  {
+    int next = 0;
+    std::vector<int> out;
+    std::atomic_int inflight{0}, peak{0};
+
+    stz::Pipeline pipe(6);
+    pipe.source<int>([&](int& value)
+    {
+      if (next == 5000)
+      {
+        return false;
+      }
+      value = next++;
+      int now = ++inflight, seen = peak;
+      while (now > seen and not peak.compare_exchange_weak(seen, now));
+      return true;
+    })
+    .stage(stz::Stage(mode), [](int value)
+    {
+      if (value % 7 == 0)
+      {
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+      }
+      return std::to_string(value);
+    })
+    .stage(stz::parallel, [](std::string text){ return text + "!"; })
+    .stage(stz::serial, [&](std::string text){ out.push_back(std::stoi(text)); --inflight; });
+
+    // a pipeline can run again once done
+    for (unsigned round = 0; round < 2; ++round)
+    {
+      next = 0;
+      out.clear();
+      pipe.run(pool).get();
+      assert(out.size() == 5000);
+      for (unsigned k = 0; k < 5000; ++k)
+      {
+        assert(out[k] == static_cast<int>(k));
+      }
+    }
+    assert(peak <= 6);
+  }
+}
+
+static void test_unordered_sink(stz::Pool& pool)
+{
+  int next = 0;
+  std::vector<int> out;
+
+  stz::Pipeline pipe(8);
+  pipe.source<int>([&](int& value){ if (next == 3000) return false; value = next++; return true; })
+  .stage(stz::parallel_ordered, [](int value)
+  {
+    if (value % 5 == 0)
+    {
+      std::this_thread::sleep_for(std::chrono::microseconds(30));
+    }
+    return value;
+  })
+  .stage(stz::serial_unordered, [&](int value){ out.push_back(value); });
+
+  pipe.run(pool).get();
+  assert(out.size() == 3000);
+  for (unsigned k = 0; k < 3000; ++k)
+  {
+    assert(out[k] == static_cast<int>(k));
+  }
+}
+
+static void test_empty(stz::Pool& pool)
+{
+  stz::Pipeline pipe(3);
+  pipe.source<int>([](int&){ return false; }).stage(stz::parallel, [](int){});
+  pipe.run(pool).get();
+}
+
+int main()
+{
+  stz::Pool pool(4);
+  test_modes(pool);
+  test_unordered_sink(pool);
+  test_empty(pool);
+  pool.wait();
+}
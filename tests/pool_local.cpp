@@ -0,0 +1,94 @@
+#undef NDEBUG
+#include <cassert>
+#include <thread>
+#include <vector>
+#include "Nimata.hpp"
+
+static void test_workers()
+{
+  stz::Pool pool(3);
+  assert(stz::this_worker::index() == -1);
+
+  stz::Pool::local<long> sums(pool);
+  stz::Pool::local<std::vector<int>> scratch(pool, []{ return std::vector<int>(16); });
+
+  pool.parfor(size_t k, 10000)
+  {
+    *sums += long(k);
+    scratch->at(0)++;
+    assert(stz::this_worker::index() >= 0);
+  };
+
+  assert(sums.combine(0L, [](long a, long& b){ return a + b; }) == 49995000L);
+
+  int count = 0;
+  for (std::vector<int>& each : scratch)
+  {
+    count += each[0];
+  }
+  assert(count == 10000);
+
+  sums.clear();
+  assert(sums.begin() == sums.end());
+}
+
+static void test_strangers()
+{
+  stz::Pool pool(2);
+  stz::Pool::local<long> counts(pool);
+
+  std::vector<std::thread> threads;
+  for (unsigned k = 0; k < 8; ++k)
+  {
+    threads.emplace_back([&counts]
+    {
+      for (unsigned n = 0; n < 100000; ++n)
+      {
+        ++counts.get();
+      }
+    });
+  }
+  for (std::thread& thread : threads)
+  {
+    thread.join();
+  }
+
+  ++counts.get();
+
+  unsigned instances = 0;
+  for (long& count : counts)
+  {
+    assert(count == 100000 or count == 1);
+    ++instances;
+  }
+  assert(instances == 9);
+  assert(counts.combine(0L, [](long a, long& b){ return a + b; }) == 800001L);
+}
+
+static void test_resize()
+{
+  stz::Pool pool(2);
+  stz::Pool::local<long> sums(pool);
+
+  pool.size(6);
+  pool.parfor(size_t k, 100000)
+  {
+    *sums += long(k);
+  };
+  assert(sums.combine(0L, [](long a, long& b){ return a + b; }) == 4999950000L);
+
+  pool.size(1);
+  sums.clear();
+  pool.parfor(size_t k, 1000)
+  {
+    *sums += long(k);
+  };
+  assert(sums.combine(0L, [](long a, long& b){ return a + b; }) == 499500L);
+}
+
+int main()
+{
+  test_workers();
+  test_strangers();
+  test_resize();
+}
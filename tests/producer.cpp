@@ -0,0 +1,110 @@
+#undef NDEBUG
+#include <cassert>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "Nimata.hpp"
+
+static std::atomic_long counter{0};
+
+static void tiny()
+{
+  counter.fetch_add(1, std::memory_order_relaxed);
+}
+
+static void test_buffering(stz::Pool& pool)
+{
+  counter = 0;
+  {
+    stz::Producer producer(pool, 8);
+
+    // buffered tasks are not seen by the pool until published
+    for (unsigned k = 0; k < 5; ++k)
+    {
+      producer.push(tiny);
+    }
+    assert(producer.size() == 5);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    assert(counter == 0);
+
+    producer.flush();
+    assert(producer.size() == 0);
+    pool.wait();
+    assert(counter == 5);
+
+    // a full buffer is published at once
+    for (unsigned k = 0; k < 8; ++k)
+    {
+      producer.push(tiny);
+    }
+    assert(producer.size() == 0);
+
+    std::future<int> bound = producer.push<stz::bound>([]{ return 42; });
+    stz::Future<int> chained = producer.push<stz::chained>([]{ return 7; });
+    assert(producer.size() == 2);
+    producer.wait();
+    assert(bound.get() == 42 and chained.get() == 7 and counter == 13);
+
+    producer.push(tiny);
+  }
+  pool.wait();
+  assert(counter == 14);
+
+  // pushes made straight to the pool are not diverted
+  {
+    stz::Producer producer(pool, 100);
+    pool.push(tiny);
+    pool.wait();
+    assert(counter == 15 and producer.size() == 0);
+  }
+}
+
+static void test_bounded(stz::Pool& pool)
+{
+  counter = 0;
+  pool.capacity(4, stz::caller_runs);
+  {
+    stz::Producer producer(pool, 64);
+    for (unsigned k = 0; k < 1000; ++k)
+    {
+      producer.push(tiny);
+    }
+  }
+  pool.wait();
+  pool.capacity(0);
+
+  assert(counter == 1000);
+}
+
+static void test_threads(stz::Pool& pool)
+{
+  counter = 0;
+
+  std::vector<std::thread> threads;
+  for (unsigned k = 0; k < 4; ++k)
+  {
+    threads.emplace_back([&pool]
+    {
+      stz::Producer producer(pool, 256);
+      for (unsigned n = 0; n < 250000; ++n)
+      {
+        producer.push(tiny);
+      }
+    });
+  }
+  for (std::thread& thread : threads)
+  {
+    thread.join();
+  }
+  pool.wait();
+
+  assert(counter == 1000000);
+}
+
+int main()
+{
+  stz::Pool pool(4);
+  test_buffering(pool);
+  test_bounded(pool);
+  test_threads(pool);
+}
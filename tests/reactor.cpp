@@ -0,0 +1,151 @@
+#undef NDEBUG
+#include <cassert>
+#include <cstring>
+#include <memory>
+#include <string>
+#include "Nimata.hpp"
+
+#if defined(__linux__)
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+static void test_file(stz::Pool& pool, stz::Reactor& reactor)
+{
+  char path[] = "/tmp/nimata_reactorXXXXXX";
+  const int file = mkstemp(path);
+  assert(file >= 0);
+
+  const char message[] = "hello reactor";
+  char buffer[64] = {};
+  assert(reactor.write(file, message, sizeof(message), 0).get() == static_cast<ssize_t>(sizeof(message)));
+  assert(reactor.read(file, buffer, sizeof(buffer), 0).get() == static_cast<ssize_t>(sizeof(message)));
+  assert(std::strcmp(buffer, message) == 0);
+
+  // completions run on a worker of the pool
+  std::atomic_int worker{-2};
+  std::atomic_bool done{false};
+  reactor.read(file, buffer, 5, 6, [&](ssize_t result){ assert(result == 5); worker = stz::this_worker::index(); done = true; });
+  while (not done)
+  {
+    std::this_thread::yield();
+  }
+  assert(worker >= 0);
+
+  close(file);
+  unlink(path);
+  pool.wait();
+}
+
+static void test_pipe(stz::Reactor& reactor)
+{
+  int ends[2];
+  assert(pipe(ends) == 0);
+
+  // a read submitted before the data is there completes once it is
+  char buffer[16] = {};
+  stz::Future<ssize_t> pending = reactor.read(ends[0], buffer, sizeof(buffer));
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  assert(not pending.ready());
+  assert(reactor.write(ends[1], "pipe!", 5).get() == 5);
+  assert(pending.get() == 5 and std::memcmp(buffer, "pipe!", 5) == 0);
+
+  // two reads lined up on a blocking pipe, one completes and the other waits for more data without blocking the reactor
+  char first[4];
+  char second[4];
+  stz::Future<ssize_t> one = reactor.read(ends[0], first, sizeof(first));
+  stz::Future<ssize_t> two = reactor.read(ends[0], second, sizeof(second));
+  assert(reactor.write(ends[1], "abcd", 4).get() == 4);
+  while (not one.ready() and not two.ready())
+  {
+    std::this_thread::yield();
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  assert(one.ready() != two.ready());
+  assert(reactor.write(ends[1], "efgh", 4).get() == 4);
+  assert(one.get() == 4 and two.get() == 4);
+  assert(std::string(first, 4) + std::string(second, 4) == "abcdefgh" or std::string(second, 4) + std::string(first, 4) == "abcdefgh");
+  assert((fcntl(ends[0], F_GETFL) & O_NONBLOCK) == 0);
+
+  for (unsigned k = 0; k < 200; ++k)
+  {
+    stz::Future<ssize_t> read = reactor.read(ends[0], buffer, 1);
+    assert(reactor.write(ends[1], "x", 1).get() == 1 and read.get() == 1);
+  }
+
+  close(ends[0]);
+  close(ends[1]);
+}
+
+static void test_socket(stz::Pool& pool, stz::Reactor& reactor)
+{
+  const int listener = socket(AF_INET, SOCK_STREAM, 0);
+  sockaddr_in address = {};
+  address.sin_family      = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t length = sizeof(address);
+  assert(bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0 and listen(listener, 4) == 0);
+  assert(getsockname(listener, reinterpret_cast<sockaddr*>(&address), &length) == 0);
+
+  stz::Future<int> accepted = reactor.accept(listener);
+  const int client = socket(AF_INET, SOCK_STREAM, 0);
+  assert(connect(client, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0);
+  const int server = accepted.get();
+  assert(server >= 0);
+
+  char buffer[8] = {};
+  stz::Future<std::string> received = reactor.read(server, buffer, sizeof(buffer)).then(pool, [&buffer](ssize_t size)
+  {
+    return std::string(buffer, static_cast<size_t>(size));
+  });
+  assert(reactor.write(client, "ping", 4).get() == 4);
+  assert(received.get() == "ping");
+
+  close(server);
+  close(client);
+  close(listener);
+}
+
+// operations still pending when the reactor is destroyed are cancelled
+static void test_cancel(stz::Pool& pool, const stz::Backend backend)
+{
+  int ends[2];
+  assert(pipe(ends) == 0);
+
+  char buffer[1];
+  std::unique_ptr<stz::Reactor> reactor(new stz::Reactor(pool, backend));
+  stz::Future<ssize_t> never = reactor->read(ends[0], buffer, 1);
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  reactor.reset();
+  assert(never.get() == -ECANCELED);
+
+  close(ends[0]);
+  close(ends[1]);
+}
+
+static void test(const stz::Backend backend)
+{
+  stz::Pool pool(4);
+  stz::Reactor reactor(pool, backend);
+  assert(backend == stz::io_uring or reactor.backend() == stz::epoll);
+
+  test_file(pool, reactor);
+  test_pipe(reactor);
+  test_socket(pool, reactor);
+  test_cancel(pool, backend);
+  assert(reactor.read(12345, nullptr, 1).get() == -EBADF);
+
+  pool.wait();
+}
+
+int main()
+{
+  test(stz::epoll);
+  test(stz::io_uring);
+}
+
+#else
+int main() {}
+#endif
@@ -0,0 +1,187 @@
+#undef NDEBUG
+#include <cassert>
+#include <cstring>
+#include <sys/wait.h>
+#include "Nimata.hpp"
+
+#if defined(__linux__) and defined(__GLIBC__)
+// a full queue refuses posts and keeps its payloads, whatever its capacity
+static void test_capacity(const size_t capacity, const size_t held)
+{
+  stz::SharedQueue queue(nullptr, capacity, sizeof(int));
+  assert(queue.valid() and queue.capacity() == held);
+
+  for (int k = 0; k < static_cast<int>(held); ++k)
+  {
+    assert(queue.try_post(1, &k, sizeof(k)));
+  }
+  const int refused = -1;
+  assert(queue.try_post(1, &refused, sizeof(refused)) == false);
+  assert(queue.size() == held);
+}
+
+static void test_named()
+{
+  stz::SharedQueue::unlink("/nimata_test_queue");
+  stz::SharedQueue created("/nimata_test_queue", 4, 16);
+  assert(created.valid() and created.capacity() == 4 and created.payload() == 16);
+
+  // opening an existing name keeps the limits it was created with
+  stz::SharedQueue opened("/nimata_test_queue", 100, 100);
+  assert(opened.valid() and opened.capacity() == 4);
+
+  char large[17] = {};
+  assert(created.try_post(1, large, sizeof(large)) == false);
+  for (int k = 0; k < 4; ++k)
+  {
+    assert(created.post(1, k));
+  }
+  assert(opened.try_post(1, large, 1) == false);
+  assert(opened.size() == 4);
+
+  std::atomic_int sum{0};
+  stz::Pool pool(2);
+  opened.handle(1, [&](const void* data_, size_t size_){ assert(size_ == sizeof(int)); sum += *static_cast<const int*>(data_); });
+  opened.consume(pool);
+  while (sum != 6)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  assert(stz::SharedQueue::unlink("/nimata_test_queue"));
+}
+
+// two processes consume the same anonymous queue and share its payloads
+static void test_processes()
+{
+  struct Counters
+  {
+    std::atomic_long count[2];
+    std::atomic_long sum;
+  };
+  Counters* const counters = static_cast<Counters*>(
+    mmap(nullptr, sizeof(Counters), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0));
+  new(counters) Counters{};
+
+  stz::SharedQueue queue(nullptr, 64, sizeof(long));
+  const long tasks = 2000;
+
+  pid_t children[2];
+  for (int p = 0; p < 2; ++p)
+  {
+    children[p] = fork();
+    if (children[p] == 0)
+    {
+      {
+        stz::SharedQueue inherited(queue.fd());
+        assert(inherited.valid() and inherited.capacity() == 64);
+
+        stz::Pool pool(2);
+        inherited.handle(7, [=](const void* data_, size_t){
+          std::this_thread::sleep_for(std::chrono::microseconds(200));
+          counters->sum += *static_cast<const long*>(data_);
+          ++counters->count[p];
+        });
+        inherited.consume(pool);
+
+        while (counters->count[0] + counters->count[1] < tasks)
+        {
+          std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+      }
+      _exit(0);
+    }
+  }
+
+  for (long k = 0; k < tasks; ++k)
+  {
+    assert(queue.post(7, k));
+  }
+
+  for (const pid_t child : children)
+  {
+    int status;
+    waitpid(child, &status, 0);
+    assert(WIFEXITED(status) and WEXITSTATUS(status) == 0);
+  }
+
+  assert(counters->sum == tasks * (tasks - 1) / 2);
+  assert(counters->count[0] > tasks / 4 and counters->count[1] > tasks / 4);
+}
+
+// processes killed while posting or taking large payloads do not wedge the ring for the others
+static void test_killed()
+{
+  static char payload[1 << 18];
+  stz::SharedQueue queue(nullptr, 8, sizeof(payload));
+
+  for (unsigned round = 0; round < 40; ++round)
+  {
+    pid_t children[3];
+    for (int p = 0; p < 3; ++p)
+    {
+      children[p] = fork();
+      if (children[p] == 0)
+      {
+        stz::SharedQueue inherited(queue.fd());
+        if (p == 0)
+        {
+          stz::Pool pool(1);
+          inherited.handle(1, [](const void*, size_t){});
+          inherited.consume(pool);
+          while (true)
+          {
+            pause();
+          }
+        }
+
+        for (long k = 0;; ++k)
+        {
+          std::memcpy(payload, &k, sizeof(k));
+          inherited.try_post(1, payload, sizeof(payload));
+        }
+      }
+    }
+
+    std::this_thread::sleep_for(std::chrono::microseconds(200 + round % 7 * 50));
+    for (const pid_t child : children)
+    {
+      kill(child, SIGKILL);
+    }
+    for (const pid_t child : children)
+    {
+      waitpid(child, nullptr, 0);
+    }
+  }
+
+  std::atomic_int received{0};
+  stz::Pool pool(2);
+  queue.handle(2, [&](const void*, size_t){ ++received; });
+  queue.handle(1, [](const void*, size_t){});
+  queue.consume(pool);
+
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  for (int k = 0; k < 100; ++k)
+  {
+    assert(queue.post(2, &k, sizeof(k)));
+  }
+  while (received != 100)
+  {
+    assert(std::chrono::steady_clock::now() < deadline);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+}
+
+int main()
+{
+  test_capacity(0, 1);
+  test_capacity(1, 1);
+  test_capacity(2, 2);
+  test_named();
+  test_processes();
+  test_killed();
+}
+#else
+int main()
+{}
+#endif
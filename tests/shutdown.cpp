@@ -0,0 +1,167 @@
+#undef NDEBUG
+#include <cassert>
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+#include "Nimata.hpp"
+
+using std::chrono::milliseconds;
+
+// running tasks finish, queued ones are discarded and break their promise
+static void test_abandon()
+{
+  stz::Pool pool(2);
+  std::atomic_int ran{0};
+
+  for (unsigned k = 0; k < 2; ++k)
+  {
+    pool.push([&]{ std::this_thread::sleep_for(milliseconds(50)); ++ran; });
+  }
+  std::this_thread::sleep_for(milliseconds(10));
+
+  std::vector<std::future<int>> bound;
+  std::vector<stz::Future<int>> chained;
+  for (unsigned k = 0; k < 100; ++k)
+  {
+    bound.push_back(pool.push<stz::bound>([&]{ ++ran; return 1; }));
+    chained.push_back(pool.push<stz::chained>([&]{ ++ran; return 1; }));
+  }
+  stz::Future<int> next = pool.push<stz::chained>([]{ return 2; }).then(pool, [](int x){ return x * 2; });
+
+  assert(pool.abandon() == 201 and ran == 2);
+
+  for (std::future<int>& future : bound)
+  {
+    try
+    {
+      future.get();
+      assert(false);
+    }
+    catch (const std::future_error& error)
+    {
+      assert(error.code() == std::future_errc::broken_promise);
+    }
+  }
+  for (stz::Future<int>& future : chained)
+  {
+    assert(future.ready() and future.broken());
+  }
+  next.wait();
+  assert(next.broken());
+
+  // the pool remains usable
+  assert(pool.push<stz::chained>([]{ return 5; }).then(pool, [](int x){ return x + 1; }).get() == 6);
+}
+
+// tiny tasks pushed behind busy workers are lined up in their mailbox, they are discarded all the same
+static void test_lined_up()
+{
+  stz::Pool pool(2);
+  std::atomic_int ran{0};
+
+  for (unsigned k = 0; k < 100000; ++k)
+  {
+    pool.push([]{});
+  }
+  pool.wait();
+
+  for (unsigned k = 0; k < 2; ++k)
+  {
+    pool.push([]{ std::this_thread::sleep_for(milliseconds(50)); });
+  }
+  std::this_thread::sleep_for(milliseconds(10));
+  for (unsigned k = 0; k < 10000; ++k)
+  {
+    pool.push([&ran]{ ++ran; });
+  }
+  std::this_thread::sleep_for(milliseconds(10));
+
+  assert(pool.abandon() == 10000 and ran == 0);
+}
+
+static void test_strands()
+{
+  stz::Pool pool(1);
+  std::atomic_int ran{0};
+
+  pool.push([]{ std::this_thread::sleep_for(milliseconds(50)); });
+  std::this_thread::sleep_for(milliseconds(10));
+
+  stz::Strand strand = pool.strand(7);
+  for (unsigned k = 0; k < 100; ++k)
+  {
+    strand.push([&ran]{ ++ran; });
+  }
+
+  assert(pool.abandon() == 100 and ran == 0);
+
+  // the strand keeps working afterward
+  strand.push([&ran]{ ++ran; });
+  pool.wait();
+  assert(ran == 1);
+}
+
+// continuations are internal work, they survive abandoning
+static void test_continuations()
+{
+  stz::Pool pool(1);
+  stz::Future<int> first = pool.push<stz::chained>([]{ std::this_thread::sleep_for(milliseconds(30)); return 3; });
+  stz::Future<int> second = first.then(pool, [](int x){ return x + 1; });
+  std::this_thread::sleep_for(milliseconds(5));
+
+  pool.abandon();
+  second.wait();
+  assert(second.ready());
+}
+
+static void test_shutdown_for()
+{
+  stz::Pool pool(2);
+  std::atomic_int ran{0};
+
+  for (unsigned k = 0; k < 10; ++k)
+  {
+    pool.push([&]{ ++ran; });
+  }
+  assert(pool.shutdown_for(milliseconds(500)) and ran == 10);
+
+  for (unsigned k = 0; k < 1000; ++k)
+  {
+    pool.push([&]{ std::this_thread::sleep_for(milliseconds(5)); ++ran; });
+  }
+  const auto start = std::chrono::steady_clock::now();
+  assert(pool.shutdown_for(milliseconds(50)) == false);
+  assert(std::chrono::steady_clock::now() - start < milliseconds(500));
+}
+
+static void test_stopped()
+{
+  stz::Pool pool(2);
+  std::atomic_int ran{0};
+
+  pool.stop();
+  for (unsigned k = 0; k < 10; ++k)
+  {
+    pool.push([&]{ ++ran; });
+  }
+  assert(pool.abandon() == 10 and ran == 0);
+
+  pool.work();
+  for (unsigned k = 0; k < 10; ++k)
+  {
+    pool.push([&]{ ++ran; });
+  }
+  pool.drain();
+  assert(ran == 10);
+}
+
+int main()
+{
+  test_abandon();
+  test_lined_up();
+  test_strands();
+  test_continuations();
+  test_shutdown_for();
+  test_stopped();
+}
@@ -0,0 +1,52 @@
+#undef NDEBUG
+#include <cassert>
+#include "Nimata.hpp"
+
+#if defined(__linux__)
+#include <pthread.h>
+
+static auto current_stack_size() -> size_t
+{
+  pthread_attr_t attributes;
+  pthread_getattr_np(pthread_self(), &attributes);
+  size_t size = 0;
+  pthread_attr_getstacksize(&attributes, &size);
+  pthread_attr_destroy(&attributes);
+  return size;
+}
+
+static void test_stack_size()
+{
+  stz::Pool pool(2, 256 * 1024);
+  assert(pool.stack_size() == 256 * 1024);
+  assert(pool.push<stz::bound>(current_stack_size).get() == 256 * 1024);
+
+  // workers added later get the same stack size
+  pool.size(3);
+  std::atomic_int count{0};
+  pool.parfor(size_t k, 100)
+  {
+    assert(current_stack_size() == 256 * 1024);
+    ++count;
+  };
+  assert(count == 100);
+}
+
+static void test_small_stacks()
+{
+  for (unsigned k = 0; k < 20; ++k)
+  {
+    stz::Pool pool(8, 64 * 1024);
+    pool.push([]{});
+  }
+}
+
+int main()
+{
+  test_stack_size();
+  test_small_stacks();
+}
+
+#else
+int main() {}
+#endif
@@ -0,0 +1,82 @@
+#undef NDEBUG
+#include <cassert>
+#include <chrono>
+#include <thread>
+#include "Nimata.hpp"
+
+#if defined(__linux__)
+#include <dirent.h>
+
+static auto threads() -> unsigned
+{
+  unsigned count = 0;
+  DIR* const directory = opendir("/proc/self/task");
+  while (readdir(directory) != nullptr)
+  {
+    ++count;
+  }
+  closedir(directory);
+  return count - 2;
+}
+
+static void test_lazy()
+{
+  const unsigned before = threads();
+
+  stz::Pool pool(stz::lazy, 4);
+  assert(threads() == before);
+
+  std::atomic_int count{0};
+  pool.parfor(size_t k, 100)
+  {
+    ++count;
+  };
+  assert(count == 100 and threads() > before);
+}
+
+// workers are only spawned while every spawned one is busy and work is waiting
+static void test_gradual()
+{
+  const unsigned before = threads();
+
+  stz::Pool pool(stz::gradual, 4);
+  assert(threads() == before);
+
+  assert(pool.push([]{ return 7; }).get() == 7);
+  pool.wait();
+  const unsigned first = threads() - before;
+  assert(first >= 1);
+
+  pool.parfor(size_t k, 40)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  };
+  assert(threads() - before >= first);
+
+  pool.size(2);
+  pool.parfor(size_t k, 4) {};
+}
+
+static void test_resized_before_start()
+{
+  {
+    stz::Pool pool(stz::lazy, 2);
+    pool.size(3);
+    pool.push([]{});
+    pool.wait();
+  }
+  {
+    stz::Pool pool(stz::lazy, 2);
+  }
+}
+
+int main()
+{
+  test_lazy();
+  test_gradual();
+  test_resized_before_start();
+}
+
+#else
+int main() {}
+#endif
@@ -0,0 +1,89 @@
+#undef NDEBUG
+#include <cassert>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Nimata.hpp"
+
+// tasks of a key run one at a time and in the order they were pushed, even from several threads
+static void test_order(stz::Pool& pool)
+{
+  const unsigned keys = 50, each = 2000;
+  std::vector<int> last(keys, -1);
+  std::vector<std::atomic_int> inside(keys);
+  std::atomic_bool wrong{false};
+
+  std::vector<std::thread> producers;
+  for (unsigned producer = 0; producer < 2; ++producer)
+  {
+    producers.emplace_back([&, producer]
+    {
+      for (unsigned n = 0; n < each; ++n)
+      {
+        for (unsigned key = producer; key < keys; key += 2)
+        {
+          pool.push_keyed(key, [&, key, n]
+          {
+            if (++inside[key] != 1 or last[key] != static_cast<int>(n) - 1)
+            {
+              wrong = true;
+            }
+            last[key] = static_cast<int>(n);
+            --inside[key];
+          });
+        }
+      }
+    });
+  }
+  for (std::thread& producer : producers)
+  {
+    producer.join();
+  }
+  pool.wait();
+
+  assert(not wrong);
+  for (unsigned key = 0; key < keys; ++key)
+  {
+    assert(last[key] == static_cast<int>(each) - 1);
+  }
+}
+
+static void test_handle(stz::Pool& pool)
+{
+  stz::Strand strand = pool.strand(std::string("account-42"));
+  std::vector<int> seen;
+
+  for (int n = 0; n < 1000; ++n)
+  {
+    strand.push([&seen](int x){ seen.push_back(x); }, n);
+  }
+  pool.wait();
+
+  assert(seen.size() == 1000);
+  for (unsigned n = 0; n < 1000; ++n)
+  {
+    assert(seen[n] == static_cast<int>(n));
+  }
+}
+
+// distinct keys run concurrently
+static void test_parallel(stz::Pool& pool)
+{
+  const auto start = std::chrono::steady_clock::now();
+  for (unsigned key = 0; key < 4; ++key)
+  {
+    pool.push_keyed(key, []{ std::this_thread::sleep_for(std::chrono::milliseconds(100)); });
+  }
+  pool.wait();
+
+  assert(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(350));
+}
+
+int main()
+{
+  stz::Pool pool(4);
+  test_order(pool);
+  test_handle(pool);
+  test_parallel(pool);
+}
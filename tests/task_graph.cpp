@@ -0,0 +1,76 @@
+#undef NDEBUG
+#include <cassert>
+#include <memory>
+#include "Nimata.hpp"
+
+static void test_diamond(stz::Pool& pool)
+{
+  stz::TaskGraph graph;
+  std::atomic_int parsed{0}, transformed{0}, joined{0};
+
+  const stz::TaskGraph::Node parse = graph.node([&]{ ++parsed; });
+  const stz::TaskGraph::Node join  = graph.node([&]{ assert(transformed == 8); ++joined; });
+  for (unsigned k = 0; k < 8; ++k)
+  {
+    const stz::TaskGraph::Node transform = graph.node([&]{ assert(parsed == joined + 1); ++transformed; });
+    graph.precede(parse, transform);
+    graph.precede(transform, join);
+  }
+
+  // a graph can run again once done
+  for (unsigned run = 0; run < 200; ++run)
+  {
+    transformed = 0;
+    graph.run(pool).wait();
+    assert(joined == static_cast<int>(run + 1));
+  }
+}
+
+static void test_chain(stz::Pool& pool)
+{
+  stz::TaskGraph graph;
+  int value = 0;
+
+  stz::TaskGraph::Node previous = graph.node([&]{ value = 1; });
+  for (unsigned k = 0; k < 100; ++k)
+  {
+    const stz::TaskGraph::Node node = graph.node([&]{ ++value; });
+    graph.precede(previous, node);
+    previous = node;
+  }
+
+  graph.run(pool).get();
+  assert(value == 101);
+}
+
+// the graph is destroyed as soon as its last node is done
+static void test_lifetime(stz::Pool& pool)
+{
+  for (unsigned round = 0; round < 2000; ++round)
+  {
+    std::unique_ptr<stz::TaskGraph> graph(new stz::TaskGraph);
+    const stz::TaskGraph::Node first = graph->node([]{});
+    for (unsigned k = 0; k < 4; ++k)
+    {
+      graph->precede(first, graph->node([]{}));
+    }
+
+    graph->run(pool).wait();
+    graph.reset();
+  }
+}
+
+static void test_empty(stz::Pool& pool)
+{
+  stz::TaskGraph graph;
+  graph.run(pool).wait();
+}
+
+int main()
+{
+  stz::Pool pool(3);
+  test_diamond(pool);
+  test_chain(pool);
+  test_lifetime(pool);
+  test_empty(pool);
+}
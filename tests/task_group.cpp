@@ -0,0 +1,109 @@
+#undef NDEBUG
+#include <algorithm>
+#include <cassert>
+#include <random>
+#include <vector>
+#include "Nimata.hpp"
+
+static auto fib(stz::Pool& pool, const unsigned n) -> long
+{
+  if (n < 12)
+  {
+    return n < 2 ? static_cast<long>(n) : fib(pool, n - 1) + fib(pool, n - 2);
+  }
+
+  long a = 0, b = 0;
+  stz::parallel_invoke(pool, [&]{ a = fib(pool, n - 1); }, [&]{ b = fib(pool, n - 2); });
+  return a + b;
+}
+
+static void sort(stz::Pool& pool, unsigned* const low, unsigned* const high)
+{
+  if (high - low < 512)
+  {
+    std::sort(low, high);
+    return;
+  }
+
+  const unsigned pivot = low[(high - low) / 2];
+  unsigned* const middle1 = std::partition(low, high, [pivot](unsigned x){ return x < pivot; });
+  unsigned* const middle2 = std::partition(middle1, high, [pivot](unsigned x){ return not (pivot < x); });
+
+  stz::TaskGroup group(pool);
+  group.spawn([&pool, low, middle1]{ sort(pool, low, middle1); });
+  group.spawn([&pool, middle2, high]{ sort(pool, middle2, high); });
+  group.sync();
+}
+
+static void test_recursion(stz::Pool& pool)
+{
+  assert(fib(pool, 27) == 196418);
+
+  std::vector<unsigned> values(200000);
+  std::mt19937 random(1);
+  for (unsigned& value : values)
+  {
+    value = static_cast<unsigned>(random() % 10000);
+  }
+  sort(pool, values.data(), values.data() + values.size());
+  assert(std::is_sorted(values.begin(), values.end()));
+}
+
+// a scope is reused after each sync, past its in-place children and across its blocks
+static void test_reuse(stz::Pool& pool)
+{
+  std::atomic_long count{0};
+  stz::TaskGroup group(pool);
+
+  for (unsigned round = 0; round < 4; ++round)
+  {
+    const unsigned spawned = round == 0 ? 3 : 1000 * round;
+    for (unsigned k = 0; k < spawned; ++k)
+    {
+      group.spawn([&count]{ ++count; });
+    }
+    group.sync();
+  }
+
+  assert(count == 3 + 1000 + 2000 + 3000);
+}
+
+// sync works through the pool's queue, which holds more than the children of the scope
+static void test_help(stz::Pool& pool)
+{
+  std::atomic_long other{0}, children{0};
+
+  for (unsigned k = 0; k < 10000; ++k)
+  {
+    pool.push([&other]{ ++other; });
+  }
+  {
+    stz::TaskGroup group(pool);
+    for (unsigned k = 0; k < 100; ++k)
+    {
+      group.spawn([&children]{ ++children; });
+    }
+  }
+  assert(children == 100);
+
+  pool.wait();
+  assert(other == 10000);
+}
+
+static void test_empty(stz::Pool& pool)
+{
+  stz::parallel_invoke(pool);
+  stz::TaskGroup group(pool);
+  group.sync();
+  group.sync();
+}
+
+int main()
+{
+  stz::Pool pool(4);
+  test_recursion(pool);
+  test_reuse(pool);
+  test_help(pool);
+  test_empty(pool);
+  pool.wait();
+}
@@ -0,0 +1,103 @@
+#undef NDEBUG
+#include <cassert>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "Nimata.hpp"
+
+using namespace std::chrono;
+
+// delays spread across the first level of the wheel and beyond it, every third timer cancelled,
+// timers fire within the millisecond tick they are due in
+static void test_many(stz::Pool& pool)
+{
+  const auto start = steady_clock::now();
+  std::atomic_int fired{0}, early{0};
+
+  std::vector<stz::Timer> timers;
+  for (unsigned k = 0; k < 3000; ++k)
+  {
+    const milliseconds delay((k * 7) % 600);
+    const steady_clock::time_point due = start + delay;
+    timers.push_back(pool.push_after(delay, [&fired, &early, due]
+    {
+      if (steady_clock::now() < due - milliseconds(1))
+      {
+        ++early;
+      }
+      ++fired;
+    }));
+  }
+
+  int cancelled = 0;
+  for (size_t k = 0; k < timers.size(); k += 3)
+  {
+    cancelled += timers[k].cancel() ? 1 : 0;
+  }
+
+  std::this_thread::sleep_for(milliseconds(800));
+  pool.wait();
+  assert(fired + cancelled == 3000 and early == 0);
+  assert(not timers[1].cancel());
+}
+
+static void test_clocks(stz::Pool& pool)
+{
+  std::atomic_bool later{false}, past{false};
+
+  pool.push_at(system_clock::now() + milliseconds(100), [&]{ later = true; });
+  pool.push_at(steady_clock::now() - seconds(1), [&]{ past = true; });
+  std::this_thread::sleep_for(milliseconds(30));
+  assert(past and not later);
+
+  while (not later)
+  {
+    std::this_thread::sleep_for(milliseconds(1));
+  }
+}
+
+static void test_arguments(stz::Pool& pool)
+{
+  std::atomic_int sum{0};
+  pool.push_after(milliseconds(5), [&sum](int x, int y){ sum += x + y; }, 2, 3);
+
+  while (sum == 0)
+  {
+    std::this_thread::sleep_for(milliseconds(1));
+  }
+  assert(sum == 5);
+}
+
+// a delay crossing into the second level of the wheel is cascaded down in time
+static void test_cascade(stz::Pool& pool)
+{
+  const auto start = steady_clock::now();
+  std::atomic_bool fired{false};
+
+  pool.push_after(milliseconds(1300), [&]{ fired = true; });
+  while (not fired)
+  {
+    std::this_thread::sleep_for(milliseconds(1));
+  }
+
+  const auto took = steady_clock::now() - start;
+  assert(took >= milliseconds(1299) and took < milliseconds(1800));
+}
+
+// timers not due when their pool is destroyed are dropped
+static void test_dropped()
+{
+  stz::Pool pool(2);
+  pool.push_after(hours(30000), []{ assert(false); });
+  pool.push_after(seconds(70), []{ assert(false); });
+}
+
+int main()
+{
+  stz::Pool pool(4);
+  test_many(pool);
+  test_clocks(pool);
+  test_arguments(pool);
+  test_cascade(pool);
+  test_dropped();
+}
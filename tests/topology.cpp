@@ -0,0 +1,95 @@
+#undef NDEBUG
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include "Nimata.hpp"
+
+#if defined(__linux__)
+#include <sys/stat.h>
+
+static void write_file(const std::string& path, const char* const text)
+{
+  FILE* const file = std::fopen(path.c_str(), "w");
+  assert(file != nullptr);
+  std::fputs(text, file);
+  std::fclose(file);
+}
+
+// 2 packages of 2 cores with 2 hardware threads each, 'k' and 'k + 4' are siblings
+static auto fake_sysfs() -> std::string
+{
+  char root[] = "/tmp/nimata_topologyXXXXXX";
+  assert(mkdtemp(root) != nullptr);
+
+  for (unsigned k = 0; k < 8; ++k)
+  {
+    const unsigned core = k % 4;
+    const std::string cpu = std::string(root) + "/cpu" + std::to_string(k);
+    const std::string siblings = std::to_string(core) + "," + std::to_string(core + 4);
+    const std::string package = core < 2 ? "0-1,4-5" : "2-3,6-7";
+
+    mkdir(cpu.c_str(), 0700);
+    mkdir((cpu + "/topology").c_str(), 0700);
+    mkdir((cpu + "/cache").c_str(), 0700);
+    write_file(cpu + "/topology/thread_siblings_list", siblings.c_str());
+    write_file(cpu + "/topology/core_siblings_list", package.c_str());
+
+    const char* const types[]  = {"Data", "Instruction", "Unified", "Unified"};
+    const char* const levels[] = {"1", "1", "2", "3"};
+    for (unsigned n = 0; n < 4; ++n)
+    {
+      const std::string index = cpu + "/cache/index" + std::to_string(n);
+      mkdir(index.c_str(), 0700);
+      write_file(index + "/level", levels[n]);
+      write_file(index + "/type", types[n]);
+      write_file(index + "/shared_cpu_list", n < 3 ? siblings.c_str() : package.c_str());
+    }
+  }
+
+  return root;
+}
+
+static void test_read()
+{
+  using stz::_nimata_impl::_topology;
+
+  const std::string root = fake_sysfs();
+  const _topology topology = stz::_nimata_impl::_read_topology({0, 1, 2, 3, 4, 5, 6, 7}, root);
+
+  assert(topology._threads.size() == 8 and topology._cores.size() == 4);
+  assert(_topology::_distance(topology._threads[0], topology._threads[1]) == 1);
+  assert(_topology::_distance(topology._cores[0], topology._cores[1]) == 3);
+  assert(_topology::_distance(topology._cores[0], topology._cores[2]) == 5);
+
+  const std::string command = "rm -rf " + root;
+  assert(std::system(command.c_str()) == 0);
+}
+
+static void test_physical_cores()
+{
+  std::atomic_int count{0};
+
+  stz::Pool pool(stz::physical_cores);
+  assert(pool.size() >= 1);
+  pool.parfor(size_t k, 1000)
+  {
+    ++count;
+  };
+  assert(count == 1000);
+
+  stz::Pool lazy(stz::physical_cores, stz::lazy);
+  lazy.push([&]{ ++count; });
+  lazy.wait();
+  assert(count == 1001);
+}
+
+int main()
+{
+  test_read();
+  test_physical_cores();
+}
+
+#else
+int main() {}
+#endif